@@ -17,8 +17,8 @@ TEST_CASE("algorithms: conjugate gradient", "[algorithms]")
   constexpr size_t cols{100};
   Shape const a_shape{rows, cols};
   Shape const b_shape{cols, 1};
-  Tensor a  = Tensor::rand(a_shape, devices[DeviceIdx::SERIAL]);
-  Tensor b  = Tensor::rand(b_shape, devices[DeviceIdx::SERIAL]);
+  Tensor a  = Tensor::rand(a_shape, devices[DeviceIdx::SERIAL], 1);
+  Tensor b  = Tensor::rand(b_shape, devices[DeviceIdx::SERIAL], 2);
   Tensor x0 = Tensor::zeros(b_shape, devices[DeviceIdx::SERIAL]);
 
   a = a.transpose() * a;
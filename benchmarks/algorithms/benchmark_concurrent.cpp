@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "algorithms.hpp"
+#include "device.hpp"
+#include "tensor.hpp"
+
+using namespace gpu_playground;
+
+// Every request thread runs the same number of solves on a shared device, so the time stays flat
+// as long as the throughput scales linearly with the number of request threads.
+TEST_CASE("algorithms: concurrent solves", "[algorithms]")
+{
+  auto const devices = make_devices();
+
+  constexpr size_t n{100};
+  constexpr size_t solves_per_thread{4};
+  Shape const a_shape{n, n};
+  Shape const b_shape{n, 1};
+
+  size_t const max_threads = std::max(1U, std::thread::hardware_concurrency());
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      Tensor a = Tensor::rand(a_shape, device, 1);
+      a        = a.transpose() * a;
+
+      for (size_t n_threads{1}; n_threads <= max_threads; n_threads *= 2)
+      {
+        BENCHMARK(
+            std::string(get_device_name(device->type())) + " " + std::to_string(n_threads) +
+            " request threads"
+        )
+        {
+          std::vector<std::thread> threads;
+          for (size_t t{0}; t < n_threads; t++)
+          {
+            threads.emplace_back(
+                [&a, &device, &b_shape, t]()
+                {
+                  Tensor const b  = Tensor::rand(b_shape, device, t + 2);
+                  Tensor const x0 = Tensor::zeros(b_shape, device);
+                  for (size_t solve{0}; solve < solves_per_thread; solve++)
+                  {
+                    auto const x = conjuaget_gradient(a, b, x0, 100);
+                    x.sync();
+                  }
+                }
+            );
+          }
+          for (auto &thread : threads)
+          {
+            thread.join();
+          }
+        };
+      }
+    }
+  }
+}
@@ -0,0 +1,70 @@
+#include <string>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "device.hpp"
+#include "graph.hpp"
+#include "tensor.hpp"
+
+using namespace gpu_playground;
+
+TEST_CASE("algorithms: graph replay", "[algorithms]")
+{
+  auto const devices = make_devices();
+
+  constexpr size_t rows{100};
+  constexpr size_t cols{100};
+  Shape const a_shape{rows, cols};
+  Shape const b_shape{cols, 1};
+  Shape const scalar_shape{1, 1};
+  Tensor a         = Tensor::rand(a_shape, devices[DeviceIdx::SERIAL], 1);
+  Tensor p         = Tensor::rand(b_shape, devices[DeviceIdx::SERIAL], 2);
+  Tensor r         = Tensor::rand(b_shape, devices[DeviceIdx::SERIAL], 3);
+  Tensor x         = Tensor::zeros(b_shape, devices[DeviceIdx::SERIAL]);
+  Tensor r_e       = Tensor::ones(scalar_shape, devices[DeviceIdx::SERIAL]);
+  Tensor one       = Tensor::ones(scalar_shape, devices[DeviceIdx::SERIAL]);
+  Tensor minus_one({-1.0F}, scalar_shape, devices[DeviceIdx::SERIAL]);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      a.to(device);
+      p.to(device);
+      r.to(device);
+      x.to(device);
+      r_e.to(device);
+      one.to(device);
+      minus_one.to(device);
+
+      // One conjugate gradient iteration, issued op by op or replayed from a graph.
+      auto const iteration = [&]()
+      {
+        auto const ap    = a * p;
+        auto const alpha = r_e.cdiv(p.dot(ap));
+        x.axpy(alpha, p);
+        r.axpy(alpha.smul(minus_one), ap);
+        auto const r_e_next = r.dot(r);
+        auto const beta     = r_e_next.cdiv(r_e);
+        p.axpby(one, r, beta);
+        r_e = r_e_next;
+      };
+
+      BENCHMARK(std::string(get_device_name(device->type())) + " eager")
+      {
+        iteration();
+        r_e.sync();
+      };
+
+      Graph graph;
+      graph.capture(iteration);
+
+      BENCHMARK(std::string(get_device_name(device->type())) + " replay")
+      {
+        graph.replay();
+        r_e.sync();
+      };
+    }
+  }
+}
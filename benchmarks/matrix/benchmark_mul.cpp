@@ -36,3 +36,28 @@ TEST_CASE("matrix: mul", "[matrix]")
     }
   }
 }
+
+TEST_CASE("matrix: mul tall skinny", "[matrix]")
+{
+  auto const devices = make_devices();
+
+  // a^T * a, where all the work is along the inner dimension.
+  constexpr size_t rows{100'000};
+  constexpr size_t cols{16};
+  std::vector<float> a_data(rows * cols);
+  std::iota(a_data.begin(), a_data.end(), 0.0);
+  Shape const a_shape{rows, cols};
+  Tensor a(a_data, a_shape, devices[DeviceIdx::SERIAL]);
+  Tensor at = a.transpose();
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      a.to(device);
+      at.to(device);
+
+      BENCHMARK(std::string(get_device_name(device->type()))) { return at * a; };
+    }
+  }
+}
@@ -0,0 +1,49 @@
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "device.hpp"
+#include "tensor.hpp"
+
+using namespace gpu_playground;
+
+// Queues a few element-wise ops, prepares the next input on the host meanwhile, then waits for
+// the result. On an asynchronous device the host work overlaps with the ops.
+TEST_CASE("vector: async", "[vector]")
+{
+  auto const devices = make_devices();
+
+  constexpr size_t len{size_t{1} << 22};
+  Shape const shape{len, 1};
+  std::vector<float> next(len);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr and backend::is_host_device(device->type()))
+    {
+      auto const name = std::string(get_device_name(device->type()));
+
+      for (auto const &[suffix, target] :
+           {std::pair{" sync", device}, std::pair{" async", make_async_device(device)}})
+      {
+        Tensor const a = Tensor::ones(shape, target);
+        Tensor const b = Tensor::ones(shape, target);
+        Tensor c       = Tensor::zeros(shape, target);
+
+        BENCHMARK(name + suffix)
+        {
+          Tensor::cmul_into(a, b, c);
+          c += a;
+          c -= b;
+          std::iota(next.begin(), next.end(), 0.0F);
+          c.sync();
+          return next.back();
+        };
+      }
+    }
+  }
+}
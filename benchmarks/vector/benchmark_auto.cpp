@@ -0,0 +1,56 @@
+#include <string>
+#include <vector>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "device.hpp"
+#include "tensor.hpp"
+
+using namespace gpu_playground;
+
+// Sweeps sizes across the switches of the cost model, for the auto device to be compared with
+// the best single CPU device at every size.
+TEST_CASE("vector: auto", "[vector]")
+{
+  auto const devices = make_devices();
+
+  for (size_t const len : {size_t{1} << 6, size_t{1} << 10, size_t{1} << 14, size_t{1} << 22})
+  {
+    std::vector<float> const data(len, 0.5F);
+    Shape const shape{len, 1};
+
+    for (auto const &device : devices)
+    {
+      if (device != nullptr and backend::is_host_device(device->type()))
+      {
+        Tensor const a(data, shape, device);
+        Tensor const b(data, shape, device);
+        std::string const name = std::string(get_device_name(device->type()));
+
+        BENCHMARK("add " + std::to_string(len) + " " + name) { return a + b; };
+        BENCHMARK("dot " + std::to_string(len) + " " + name) { return a.dot(b); };
+      }
+    }
+  }
+
+  for (size_t const side : {8, 64, 512})
+  {
+    std::vector<float> const data(side * side, 0.5F);
+    Shape const shape{side, side};
+    Shape const x_shape{side, 1};
+
+    for (auto const &device : devices)
+    {
+      if (device != nullptr and backend::is_host_device(device->type()))
+      {
+        Tensor const a(data, shape, device);
+        Tensor const x(std::vector<float>(side, 0.5F), x_shape, device);
+        std::string const name = std::string(get_device_name(device->type()));
+
+        BENCHMARK("mul " + std::to_string(side) + " " + name) { return a * a; };
+        BENCHMARK("gemv " + std::to_string(side) + " " + name) { return a * x; };
+      }
+    }
+  }
+}
@@ -0,0 +1,44 @@
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "device.hpp"
+#include "tensor.hpp"
+
+using namespace gpu_playground;
+
+TEST_CASE("vector: axpy", "[vector]")
+{
+  auto const devices = make_devices();
+
+  constexpr size_t len{1'000'000};
+  std::vector<float> x_data(len);
+  std::vector<float> y_data(len);
+  std::vector<float> const alpha_data{1.0};
+  std::iota(x_data.begin(), x_data.end(), 0.0);
+  std::iota(y_data.begin(), y_data.end(), 1.0);
+  Shape const shape{len, 1};
+  Shape const alpha_shape{1, 1};
+  Tensor x(x_data, shape, devices[DeviceIdx::SERIAL]);
+  Tensor y(y_data, shape, devices[DeviceIdx::SERIAL]);
+  Tensor alpha(alpha_data, alpha_shape, devices[DeviceIdx::SERIAL]);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      x.to(device);
+      y.to(device);
+      alpha.to(device);
+
+      BENCHMARK(std::string(get_device_name(device->type())))
+      {
+        y.axpy(alpha, x);
+        y.sync();
+      };
+    }
+  }
+}
@@ -0,0 +1,46 @@
+#include <string>
+#include <vector>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "basic_tensor.hpp"
+#include "device.hpp"
+#include "tensor.hpp"
+
+using namespace gpu_playground;
+
+TEST_CASE("vector: basic tensor", "[vector]")
+{
+  auto const devices = make_devices();
+
+  constexpr size_t len{64};
+  std::vector<float> const data(len, 1.0);
+  Shape const shape{len, 1};
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      Tensor const a(data, shape, device);
+      Tensor b(data, shape, device);
+      Tensor const alpha({0.5}, {1, 1}, device);
+
+      BENCHMARK(std::string(get_device_name(device->type())))
+      {
+        b.axpy(alpha, a);
+        return b.dot(a).item();
+      };
+    }
+  }
+
+  HostTensor const a(data, shape);
+  HostTensor b(data, shape);
+  HostTensor const alpha({0.5}, {1, 1});
+
+  BENCHMARK("HostTensor")
+  {
+    b.axpy(alpha, a);
+    return b.dot(a).item();
+  };
+}
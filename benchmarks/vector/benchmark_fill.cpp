@@ -0,0 +1,31 @@
+#include <string>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "device.hpp"
+#include "tensor.hpp"
+
+using namespace gpu_playground;
+
+TEST_CASE("vector: fill", "[vector]")
+{
+  auto const devices = make_devices();
+
+  constexpr size_t len{1'000'000};
+  Shape const shape{len, 1};
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      auto buffer = device->new_buffer_uninitialized(shape);
+
+      BENCHMARK(std::string(get_device_name(device->type())))
+      {
+        device->fill(buffer, 1.0);
+        device->sync(buffer);
+      };
+    }
+  }
+}
@@ -0,0 +1,44 @@
+#include <limits>
+#include <string>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "device.hpp"
+#include "tensor.hpp"
+
+using namespace gpu_playground;
+
+// Allocates a large buffer and makes a first pass over it, which pays the page faults.
+TEST_CASE("vector: large host storage", "[vector]")
+{
+  auto const devices = make_devices();
+  auto const &device = devices[DeviceIdx::SERIAL];
+
+  constexpr size_t len{size_t{16} << 20};
+  Shape const shape{len, 1};
+
+  auto &config        = backend::host_storage_config();
+  auto const previous = config;
+
+  auto const first_pass = [&]()
+  {
+    auto buffer = device->new_buffer_uninitialized(shape);
+    device->fill(buffer, 1.0);
+    return buffer.size();
+  };
+
+  config.huge_page_threshold = std::numeric_limits<size_t>::max();
+  BENCHMARK("4 KiB pages")
+  {
+    return first_pass();
+  };
+
+  config.huge_page_threshold = 0;
+  BENCHMARK("huge pages")
+  {
+    return first_pass();
+  };
+
+  config = previous;
+}
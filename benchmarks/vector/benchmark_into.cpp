@@ -0,0 +1,48 @@
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "device.hpp"
+#include "tensor.hpp"
+
+using namespace gpu_playground;
+
+TEST_CASE("vector: into", "[vector]")
+{
+  auto const devices = make_devices();
+
+  constexpr size_t len{1'000'000};
+  std::vector<float> a_data(len);
+  std::vector<float> b_data(len);
+  std::iota(a_data.begin(), a_data.end(), 0.0);
+  std::iota(b_data.begin(), b_data.end(), 1.0);
+  Shape const shape{len, 1};
+  Tensor a(a_data, shape, devices[DeviceIdx::SERIAL]);
+  Tensor b(b_data, shape, devices[DeviceIdx::SERIAL]);
+  Tensor c = Tensor::zeros(shape, devices[DeviceIdx::SERIAL]);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      a.to(device);
+      b.to(device);
+      c.to(device);
+
+      BENCHMARK(std::string(get_device_name(device->type())) + " new")
+      {
+        auto const out = a.cmul(b);
+        out.sync();
+      };
+
+      BENCHMARK(std::string(get_device_name(device->type())) + " into")
+      {
+        Tensor::cmul_into(a, b, c);
+        c.sync();
+      };
+    }
+  }
+}
@@ -0,0 +1,37 @@
+#include <string>
+#include <vector>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "device.hpp"
+#include "tensor.hpp"
+
+using namespace gpu_playground;
+
+TEST_CASE("vector: item", "[vector]")
+{
+  auto const devices = make_devices();
+
+  std::vector<float> const data{1.0};
+  Shape const shape{1, 1};
+  Tensor a(data, shape, devices[DeviceIdx::SERIAL]);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      a.to(device);
+
+      BENCHMARK(std::string(get_device_name(device->type())) + " cpu")
+      {
+        return a.cpu().front();
+      };
+
+      BENCHMARK(std::string(get_device_name(device->type())) + " item")
+      {
+        return a.item();
+      };
+    }
+  }
+}
@@ -0,0 +1,32 @@
+#include <string>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "device.hpp"
+
+using namespace gpu_playground;
+
+TEST_CASE("vector: pool", "[vector]")
+{
+  auto const devices = make_devices();
+
+  constexpr size_t len{1'000'000};
+  Shape const shape{len, 1};
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      BENCHMARK(std::string(get_device_name(device->type())) + " new")
+      {
+        return device->new_buffer_with_shape(shape);
+      };
+
+      BENCHMARK(std::string(get_device_name(device->type())) + " pooled")
+      {
+        return device->new_pooled_buffer(shape);
+      };
+    }
+  }
+}
@@ -0,0 +1,33 @@
+#include <string>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "device.hpp"
+#include "tensor.hpp"
+
+using namespace gpu_playground;
+
+TEST_CASE("vector: random", "[vector]")
+{
+  auto const devices = make_devices();
+
+  constexpr size_t len{1'000'000};
+  Shape const shape{len, 1};
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      BENCHMARK(std::string(get_device_name(device->type())) + " uniform")
+      {
+        return Tensor::rand(shape, device, 1);
+      };
+
+      BENCHMARK(std::string(get_device_name(device->type())) + " normal")
+      {
+        return Tensor::random(shape, Distribution::normal(), device, 1);
+      };
+    }
+  }
+}
@@ -0,0 +1,58 @@
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "device.hpp"
+#include "reproducible.hpp"
+#include "tensor.hpp"
+
+using namespace gpu_playground;
+
+// The cost of the reproducible mode, against the default kernels, on every CPU device.
+TEST_CASE("vector: reproducible reductions", "[vector]")
+{
+  auto const devices = make_devices();
+
+  constexpr size_t len{1'000'000};
+  constexpr size_t rows{1'000};
+  constexpr size_t cols{1'000};
+  std::vector<float> a_data(len);
+  std::vector<float> b_data(len);
+  std::iota(a_data.begin(), a_data.end(), 0.0);
+  std::iota(b_data.begin(), b_data.end(), 1.0);
+  Shape const shape{len, 1};
+  Shape const m_shape{rows, cols};
+  Tensor a(a_data, shape, devices[DeviceIdx::SERIAL]);
+  Tensor b(b_data, shape, devices[DeviceIdx::SERIAL]);
+  Tensor m(a_data, m_shape, devices[DeviceIdx::SERIAL]);
+
+  auto &config = backend::reduction_config();
+  for (auto const &device : devices)
+  {
+    if (device == nullptr or not backend::is_host_device(device->type()))
+    {
+      continue;
+    }
+
+    a.to(device);
+    b.to(device);
+    m.to(device);
+
+    for (bool const reproducible : {false, true})
+    {
+      config.reproducible = reproducible;
+      std::string const name =
+          std::string(get_device_name(device->type())) + (reproducible ? " reproducible" : " fast");
+
+      BENCHMARK(name + " dot") { return a.dot(b); };
+      BENCHMARK(name + " sum") { return a.sum(); };
+      BENCHMARK(name + " norm2") { return a.norm2(); };
+      BENCHMARK(name + " sum rows") { return m.sum(Axis::ROWS); };
+      BENCHMARK(name + " sum cols") { return m.sum(Axis::COLS); };
+    }
+    config.reproducible = false;
+  }
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "device.hpp"
+#include "tensor.hpp"
+
+using namespace gpu_playground;
+
+// The STREAM kernels (McCalpin), on arrays far larger than the caches. Copy and scale move 2 * len
+// floats per run, add and triad 3 * len, so the times convert directly to bandwidth. Buffers are
+// prefaulted, which leaves them on the node of the allocating thread under the default policy: on
+// a host with several sockets, threads only add bandwidth past the first socket when the pages
+// are first touched by the threads using them, or interleaved.
+TEST_CASE("vector: stream", "[vector]")
+{
+  constexpr size_t len{size_t{1} << 24};
+  Shape const shape{len, 1};
+  Shape const scalar_shape{1, 1};
+
+  auto &config        = backend::host_storage_config();
+  auto const previous = config;
+  config.prefault     = true;
+
+  std::vector<std::pair<std::string, DevicePtr>> devices;
+  for (auto const &device : make_devices())
+  {
+    if (device != nullptr and backend::is_host_device(device->type()))
+    {
+      devices.emplace_back(get_device_name(device->type()), device);
+    }
+  }
+#ifdef GPU_PLAYGROUND_HAS_THREADED
+  // One socket's worth of threads on a two-socket host, against all of them above.
+  size_t const half = std::max(1U, std::thread::hardware_concurrency() / 2);
+  devices.emplace_back(
+      "Threaded (" + std::to_string(half) + " threads)", make_threaded_device(half)
+  );
+#endif
+
+  std::vector<std::pair<std::string, backend::NumaPolicy>> const policies{
+      {"default", backend::NumaPolicy::DEFAULT},
+      {"first touch", backend::NumaPolicy::FIRST_TOUCH},
+      {"interleave", backend::NumaPolicy::INTERLEAVE},
+  };
+
+  for (auto const &[policy_name, policy] : policies)
+  {
+    config.numa = policy;
+
+    for (auto const &[device_name, device] : devices)
+    {
+      Tensor a = Tensor::ones(shape, device);
+      Tensor b = Tensor::ones(shape, device);
+      Tensor c = Tensor::zeros(shape, device);
+      Tensor const s(std::vector<float>{3.0F}, scalar_shape, device);
+
+      auto const name = device_name + " " + policy_name;
+
+      BENCHMARK(name + " copy")
+      {
+        c = a;
+        c.sync();
+      };
+
+      BENCHMARK(name + " scale")
+      {
+        Tensor::smul_into(c, s, b);
+        b.sync();
+      };
+
+      BENCHMARK(name + " add")
+      {
+        Tensor::add_into(a, b, c);
+        c.sync();
+      };
+
+      BENCHMARK(name + " triad")
+      {
+        a = b.lazy() + c.lazy().smul(s);
+        a.sync();
+      };
+    }
+  }
+
+  config = previous;
+}
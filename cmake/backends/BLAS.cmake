@@ -0,0 +1,39 @@
+if(NOT DEFINED BLA_VENDOR)
+  set(BLA_VENDOR OpenBLAS)
+endif()
+
+find_package(BLAS REQUIRED)
+
+find_path(CBLAS_INCLUDE_DIR cblas.h PATH_SUFFIXES openblas)
+
+if(NOT CBLAS_INCLUDE_DIR)
+  message(FATAL_ERROR
+    "GPU Playground: "
+    "Did not find cblas.h, set CBLAS_INCLUDE_DIR to the headers of ${BLA_VENDOR}"
+  )
+endif()
+
+message(STATUS
+  "GPU Playground: Found BLAS (${BLA_VENDOR}) with CBLAS headers in ${CBLAS_INCLUDE_DIR}"
+)
+
+add_library(blas_backend STATIC
+  "${SRC_DIR}/src/backends/blas/blas_device.cpp"
+)
+
+target_include_directories(blas_backend PRIVATE
+  "${SRC_DIR}/include"
+  "${SRC_DIR}/src/backends/blas"
+  "${CBLAS_INCLUDE_DIR}"
+)
+
+# The ops without a BLAS routine run on the serial device.
+target_link_libraries(blas_backend
+    serial_backend
+    ${BLAS_LIBRARIES}
+    ${BLAS_LINKER_FLAGS}
+)
+
+target_compile_definitions(blas_backend PUBLIC
+  GPU_PLAYGROUND_HAS_BLAS
+)
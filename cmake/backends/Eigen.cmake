@@ -13,6 +13,15 @@ target_link_libraries(eigen_backend
     Eigen3::Eigen
 )
 
+# Eigen splits matrix products across OpenMP threads when it is available.
+find_package(OpenMP QUIET)
+if(OpenMP_CXX_FOUND)
+  message(STATUS "GPU Playground: Eigen products run on OpenMP threads")
+  target_link_libraries(eigen_backend
+      OpenMP::OpenMP_CXX
+  )
+endif()
+
 target_compile_definitions(eigen_backend PUBLIC
   GPU_PLAYGROUND_HAS_EIGEN
 )
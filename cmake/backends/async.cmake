@@ -0,0 +1,15 @@
+find_package(Threads REQUIRED)
+
+add_library(async_backend STATIC
+  "${SRC_DIR}/src/backends/async/stream.cpp"
+  "${SRC_DIR}/src/backends/async/async_device.cpp"
+)
+
+target_include_directories(async_backend PRIVATE
+  "${SRC_DIR}/include"
+  "${SRC_DIR}/src/backends/async"
+)
+
+target_link_libraries(async_backend
+    Threads::Threads
+)
@@ -0,0 +1,9 @@
+add_library(auto_backend STATIC
+  "${SRC_DIR}/src/backends/auto/cost_model.cpp"
+  "${SRC_DIR}/src/backends/auto/auto_device.cpp"
+)
+
+target_include_directories(auto_backend PRIVATE
+  "${SRC_DIR}/include"
+  "${SRC_DIR}/src/backends/auto"
+)
@@ -1,5 +1,7 @@
 option(GPU_PLAYGROUND_ENABLE_EIGEN "Enable Eigen backend" OFF)
 option(GPU_PLAYGROUND_ENABLE_SIMD "Enable SIMD backend" OFF)
+option(GPU_PLAYGROUND_ENABLE_THREADED "Enable multithreaded SIMD backend" OFF)
+option(GPU_PLAYGROUND_ENABLE_BLAS "Enable BLAS backend" OFF)
 option(GPU_PLAYGROUND_ENABLE_METAL "Enable Metal backend" OFF)
 
 add_library(gpu_playground_backend INTERFACE)
@@ -7,8 +9,12 @@ add_library(gpu_playground::backend ALIAS gpu_playground_backend)
 
 message(STATUS "GPU Playground: serial backend always enabled")
 include(serial)
+include(async)
+include(auto)
 target_link_libraries(gpu_playground_backend INTERFACE
   serial_backend
+  async_backend
+  auto_backend
 )
 
 
@@ -28,6 +34,22 @@ if(GPU_PLAYGROUND_ENABLE_SIMD)
   )
 endif()
 
+if(GPU_PLAYGROUND_ENABLE_THREADED)
+  message(STATUS "GPU Playground: threaded backend enabled")
+  include(threaded)
+  target_link_libraries(gpu_playground_backend INTERFACE
+    threaded_backend
+  )
+endif()
+
+if(GPU_PLAYGROUND_ENABLE_BLAS)
+  message(STATUS "GPU Playground: BLAS backend enabled")
+  include(BLAS)
+  target_link_libraries(gpu_playground_backend INTERFACE
+    blas_backend
+  )
+endif()
+
 if(GPU_PLAYGROUND_ENABLE_METAL)
   if(NOT APPLE)
     message(FATAL_ERROR
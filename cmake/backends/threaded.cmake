@@ -0,0 +1,23 @@
+include(xsimd)
+
+find_package(Threads REQUIRED)
+
+add_library(threaded_backend STATIC
+  "${SRC_DIR}/src/backends/threaded/thread_pool.cpp"
+  "${SRC_DIR}/src/backends/threaded/threaded_device.cpp"
+)
+
+target_include_directories(threaded_backend PRIVATE
+  "${SRC_DIR}/include"
+  "${SRC_DIR}/src/backends/simd"
+  "${SRC_DIR}/src/backends/threaded"
+)
+
+target_link_libraries(threaded_backend
+    xsimd
+    Threads::Threads
+)
+
+target_compile_definitions(threaded_backend PUBLIC
+  GPU_PLAYGROUND_HAS_THREADED
+)
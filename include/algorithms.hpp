@@ -16,22 +16,40 @@ inline Tensor gradient_descent(
 )
 {
   Tensor x_res{x0};
+  Tensor const minus_one({-1.0F}, Shape{1, 1}, x_res.get_device());
 
-  auto r = b - a * x_res;
+  auto r   = b - a * x_res;
+  auto r_e = r.dot(r);
 
+  auto const iteration = [&]()
+  {
+    auto const ar  = a * r;
+    auto const eta = r_e.cdiv(r.dot(ar));
+    x_res.axpy(eta, r);
+    r.axpy(eta.smul(minus_one), ar);
+    // A copy rather than a move, so r_e keeps the buffer the graph recorded.
+    auto const r_e_next = r.dot(r);
+    r_e                 = r_e_next;
+  };
+
+  // Every iteration issues the same ops on the same shapes: the first one is captured and the
+  // following ones replay it on preallocated buffers.
+  Graph graph;
   for (size_t i{0}; i < max_iter; i++)
   {
-    auto const r_t = r.transpose();
-    auto const r_e = r_t * r;
-    if (std::sqrt(r_e.cpu().front()) < tol)
+    if (std::sqrt(r_e.item()) < tol)
     {
       return x_res;
     }
 
-    auto const ar   = a * r;
-    auto const eta  = r_e.cdiv(r_t * ar);
-    x_res          += r.smul(eta);
-    r              -= ar.smul(eta);
+    if (i == 0)
+    {
+      graph.capture(iteration);
+    }
+    else
+    {
+      graph.replay();
+    }
   }
 
   return x_res;
@@ -46,26 +64,44 @@ inline Tensor conjuaget_gradient(
 )
 {
   Tensor x_res{x0};
+  Tensor const one({1.0F}, Shape{1, 1}, x_res.get_device());
+  Tensor const minus_one({-1.0F}, Shape{1, 1}, x_res.get_device());
 
-  auto r = b - a * x_res;
-  auto p = r;
+  auto r   = b - a * x_res;
+  auto p   = r;
+  auto r_e = r.dot(r);
 
+  auto const iteration = [&]()
+  {
+    auto const ap    = a * p;
+    auto const alpha = r_e.cdiv(p.dot(ap));
+    x_res.axpy(alpha, p);
+    r.axpy(alpha.smul(minus_one), ap);
+    auto const r_e_next = r.dot(r);
+    auto const beta     = r_e_next.cdiv(r_e);
+    p.axpby(one, r, beta);
+    // A copy rather than a move, so r_e keeps the buffer the graph recorded.
+    r_e = r_e_next;
+  };
+
+  // Every iteration issues the same ops on the same shapes: the first one is captured and the
+  // following ones replay it on preallocated buffers.
+  Graph graph;
   for (size_t i{0}; i < max_iter; i++)
   {
-    auto const r_t = r.transpose();
-    auto const r_e = r_t * r;
-    if (std::sqrt(r_e.cpu().front()) < tol)
+    if (std::sqrt(r_e.item()) < tol)
     {
       return x_res;
     }
 
-    auto const p_t    = p.transpose();
-    auto const ap     = a * p;
-    auto const alpha  = r_e.cdiv(p_t * ap);
-    x_res            += p.smul(alpha);
-    r                -= ap.smul(alpha);
-    auto const beta   = (r.transpose() * r).cdiv(r_e);
-    p                 = r + p.smul(beta);
+    if (i == 0)
+    {
+      graph.capture(iteration);
+    }
+    else
+    {
+      graph.replay();
+    }
   }
 
   return x_res;
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "host_kernels.hpp"
+#include "host_view.hpp"
+#include "tensor.hpp"
+
+namespace gpu_playground
+{
+
+// A tensor bound to its backend at compile time. `Backend` provides the Device ops as static
+// functions, so there is no virtual call and no device pointer: for small vectors, where the
+// dispatch of Tensor costs more than the work, the ops inline down to the loops themselves.
+//
+// Tensor stays the type-erased, runtime-dispatched counterpart. Host backends share their
+// storage, so a BasicTensor<HostKernels> converts to and from a Tensor on any CPU device without
+// copying.
+template <class Backend>
+class BasicTensor
+{
+private:
+  backend::Buffer buffer;
+
+  explicit BasicTensor(backend::Buffer buffer) : buffer(std::move(buffer)) {}
+
+  static backend::Buffer take(Tensor &tensor)
+  {
+    assert(backend::is_host_device(tensor.device->type()) and "Tensor must be on a CPU device");
+    tensor.own();
+    // Ops still queued by an asynchronous device must land before the memory is used directly.
+    tensor.sync();
+    auto const shape = tensor.buffer.shape();
+    return {tensor.shared.get().take_handle(), shape, Backend::s_type};
+  }
+
+  static BasicTensor output(Shape const shape)
+  {
+    return BasicTensor{Backend::new_buffer_uninitialized(shape)};
+  }
+
+public:
+  BasicTensor()  = delete;
+  ~BasicTensor() = default;
+
+  BasicTensor(BasicTensor &&)            = default;
+  BasicTensor &operator=(BasicTensor &&) = default;
+
+  BasicTensor(std::vector<float> const &data, Shape const shape)
+      : buffer(Backend::new_buffer_uninitialized(shape))
+  {
+    assert(data.size() == this->buffer.size() and "Data does not match the shape");
+    std::copy(data.cbegin(), data.cend(), backend::host_ptr(this->buffer));
+  }
+
+  BasicTensor(BasicTensor const &other)
+      : buffer(Backend::new_buffer_uninitialized(other.buffer.shape()))
+  {
+    Backend::copy_buffer(other.buffer, this->buffer);
+  }
+
+  BasicTensor &operator=(BasicTensor const &other)
+  {
+    Backend::copy_buffer(other.buffer, this->buffer);
+
+    return *this;
+  }
+
+  // Takes over the buffer of a tensor on a CPU device.
+  explicit BasicTensor(Tensor &&tensor) : buffer(BasicTensor::take(tensor)) {}
+
+  // Hands the buffer over to a Tensor on `device`, which must be a CPU device.
+  [[nodiscard]] Tensor to_tensor(DevicePtr device) &&
+  {
+    assert(backend::is_host_device(device->type()) and "Device must be a CPU device");
+    auto const shape = this->buffer.shape();
+    auto const type  = device->type();
+    auto handle      = device->adopt_host_storage(this->buffer.take_handle());
+    return {backend::Buffer(std::move(handle), shape, type), std::move(device)};
+  }
+
+  static BasicTensor full(Shape const shape, float const value)
+  {
+    auto out = BasicTensor::output(shape);
+    Backend::fill(out.buffer, value);
+    return out;
+  }
+
+  static BasicTensor zeros(Shape const shape) { return BasicTensor::full(shape, 0.0F); }
+
+  static BasicTensor ones(Shape const shape) { return BasicTensor::full(shape, 1.0F); }
+
+  BasicTensor &operator+=(BasicTensor const &rhs)
+  {
+    Backend::add(this->buffer, rhs.buffer, this->buffer);
+
+    return *this;
+  }
+
+  BasicTensor &operator-=(BasicTensor const &rhs)
+  {
+    Backend::sub(this->buffer, rhs.buffer, this->buffer);
+
+    return *this;
+  }
+
+  [[nodiscard]] BasicTensor operator+(BasicTensor const &rhs) const
+  {
+    auto out = BasicTensor::output(this->buffer.shape());
+    Backend::add(this->buffer, rhs.buffer, out.buffer);
+    return out;
+  }
+
+  [[nodiscard]] BasicTensor operator-(BasicTensor const &rhs) const
+  {
+    auto out = BasicTensor::output(this->buffer.shape());
+    Backend::sub(this->buffer, rhs.buffer, out.buffer);
+    return out;
+  }
+
+  [[nodiscard]] BasicTensor operator*(BasicTensor const &other) const
+  {
+    auto out = BasicTensor::output(Shape{this->buffer.shape().rows, other.buffer.shape().cols});
+    Backend::mul(this->buffer, other.buffer, out.buffer);
+    return out;
+  }
+
+  [[nodiscard]] BasicTensor cmul(BasicTensor const &other) const
+  {
+    auto out = BasicTensor::output(this->buffer.shape());
+    Backend::cmul(this->buffer, other.buffer, out.buffer);
+    return out;
+  }
+
+  [[nodiscard]] BasicTensor cdiv(BasicTensor const &other) const
+  {
+    auto out = BasicTensor::output(this->buffer.shape());
+    Backend::cdiv(this->buffer, other.buffer, out.buffer);
+    return out;
+  }
+
+  [[nodiscard]] BasicTensor sadd(BasicTensor const &other) const
+  {
+    auto out = BasicTensor::output(this->buffer.shape());
+    Backend::sadd(this->buffer, other.buffer, out.buffer);
+    return out;
+  }
+
+  [[nodiscard]] BasicTensor ssub(BasicTensor const &other) const
+  {
+    auto out = BasicTensor::output(this->buffer.shape());
+    Backend::ssub(this->buffer, other.buffer, out.buffer);
+    return out;
+  }
+
+  [[nodiscard]] BasicTensor smul(BasicTensor const &other) const
+  {
+    auto out = BasicTensor::output(this->buffer.shape());
+    Backend::smul(this->buffer, other.buffer, out.buffer);
+    return out;
+  }
+
+  [[nodiscard]] BasicTensor sdiv(BasicTensor const &other) const
+  {
+    auto out = BasicTensor::output(this->buffer.shape());
+    Backend::sdiv(this->buffer, other.buffer, out.buffer);
+    return out;
+  }
+
+  // this = alpha * x + this, in a single pass.
+  BasicTensor &axpy(BasicTensor const &alpha, BasicTensor const &x)
+  {
+    Backend::axpy(alpha.buffer, x.buffer, this->buffer);
+
+    return *this;
+  }
+
+  // this = alpha * x + beta * this, in a single pass.
+  BasicTensor &axpby(BasicTensor const &alpha, BasicTensor const &x, BasicTensor const &beta)
+  {
+    Backend::axpby(alpha.buffer, x.buffer, beta.buffer, this->buffer);
+
+    return *this;
+  }
+
+  [[nodiscard]] BasicTensor transpose() const
+  {
+    auto const [rows, cols] = this->buffer.shape();
+    auto out                = BasicTensor::output(Shape{cols, rows});
+    Backend::transpose(this->buffer, out.buffer);
+    return out;
+  }
+
+  [[nodiscard]] BasicTensor dot(BasicTensor const &other) const
+  {
+    auto out = BasicTensor::output(Shape{1, 1});
+    Backend::dot(this->buffer, other.buffer, out.buffer);
+    return out;
+  }
+
+  [[nodiscard]] BasicTensor sum(Axis const axis = Axis::ALL) const
+  {
+    auto out = BasicTensor::output(reduced_shape(this->buffer.shape(), axis));
+    Backend::sum(this->buffer, out.buffer, axis);
+    return out;
+  }
+
+  [[nodiscard]] BasicTensor max(Axis const axis = Axis::ALL) const
+  {
+    auto out = BasicTensor::output(reduced_shape(this->buffer.shape(), axis));
+    Backend::max(this->buffer, out.buffer, axis);
+    return out;
+  }
+
+  [[nodiscard]] BasicTensor min(Axis const axis = Axis::ALL) const
+  {
+    auto out = BasicTensor::output(reduced_shape(this->buffer.shape(), axis));
+    Backend::min(this->buffer, out.buffer, axis);
+    return out;
+  }
+
+  [[nodiscard]] BasicTensor norm2(Axis const axis = Axis::ALL) const
+  {
+    auto out = BasicTensor::output(reduced_shape(this->buffer.shape(), axis));
+    Backend::norm2(this->buffer, out.buffer, axis);
+    return out;
+  }
+
+  [[nodiscard]] std::vector<float> cpu() const
+  {
+    auto const *data = backend::host_ptr(this->buffer);
+    return {data, data + this->buffer.size()};
+  }
+
+  [[nodiscard]] HostView host_view() const &
+  {
+    return {backend::host_ptr(this->buffer), this->buffer.shape()};
+  }
+
+  HostView host_view() const && = delete;
+
+  // The value of a 1x1 tensor.
+  [[nodiscard]] float item() const
+  {
+    assert(this->buffer.size() == 1 and "Tensor must have a single element");
+    return backend::host_ptr(this->buffer)[0];
+  }
+
+  [[nodiscard]] Shape shape() const { return this->buffer.shape(); }
+};
+
+using HostTensor = BasicTensor<backend::HostKernels>;
+
+} // namespace gpu_playground
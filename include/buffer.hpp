@@ -1,9 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <functional>
 #include <memory>
 #include <type_traits>
+#include <utility>
 
 #include "device_types.hpp"
 #include "shape.hpp"
@@ -37,6 +39,9 @@ public:
 
   [[nodiscard]] void *get() { return this->m_handle.get(); }
 
+  // Gives up ownership of the handle, e.g. to hand it over to a BufferPool.
+  [[nodiscard]] HandlePtr take_handle() { return std::move(this->m_handle); }
+
   [[nodiscard]] void const *get() const { return this->m_handle.get(); }
 
   [[nodiscard]] Shape shape() const { return this->m_shape; }
@@ -46,6 +51,61 @@ public:
   [[nodiscard]] DeviceType device_type() const { return this->m_device_type; }
 };
 
+// A buffer owned by several holders, freed with the last of them. Unlike std::shared_ptr, the
+// count is read with acquire ordering: a holder that finds itself the only one left also sees
+// the holders that let go finish with the buffer, so it can write to it in place.
+class SharedBuffer
+{
+private:
+  struct Block
+  {
+    Buffer buffer;
+    std::atomic<size_t> holders{1};
+  };
+
+  Block *block{nullptr};
+
+public:
+  SharedBuffer() = default;
+
+  explicit SharedBuffer(Buffer buffer) : block(new Block{std::move(buffer)}) {}
+
+  SharedBuffer(SharedBuffer const &other) : block(other.block)
+  {
+    if (this->block != nullptr)
+    {
+      this->block->holders.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  SharedBuffer(SharedBuffer and other) noexcept : block(std::exchange(other.block, nullptr)) {}
+
+  SharedBuffer &operator=(SharedBuffer other) noexcept
+  {
+    std::swap(this->block, other.block);
+    return *this;
+  }
+
+  ~SharedBuffer()
+  {
+    if (this->block == nullptr)
+    {
+      return;
+    }
+    if (this->block->holders.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      delete this->block;
+    }
+  }
+
+  [[nodiscard]] Buffer &get() const { return this->block->buffer; }
+
+  [[nodiscard]] bool is_shared() const
+  {
+    return this->block != nullptr and this->block->holders.load(std::memory_order_acquire) > 1;
+  }
+};
+
 template <typename... Rest>
 inline void assert_is_buffer()
 {
@@ -182,4 +242,53 @@ inline void assert_compatible_sop(
 #endif
 }
 
+inline void assert_compatible_fill([[maybe_unused]] Buffer const &buffer)
+{
+#ifndef NDEBUG
+  assert_size_nonzero(buffer);
+#endif
+}
+
+inline void assert_compatible_axpy(
+    [[maybe_unused]] Buffer const &alpha,
+    [[maybe_unused]] Buffer const &x,
+    [[maybe_unused]] Buffer const &y
+)
+{
+#ifndef NDEBUG
+  assert_same_shape(x, y);
+  assert_valid_buffers(alpha, y);
+  assert(alpha.shape().rows == 1 and "Buffer must have 1 row");
+  assert(alpha.shape().cols == 1 and "Buffer must have 1 column");
+#endif
+}
+
+inline void assert_compatible_dot(
+    [[maybe_unused]] Buffer const &a,
+    [[maybe_unused]] Buffer const &b,
+    [[maybe_unused]] Buffer const &c
+)
+{
+#ifndef NDEBUG
+  assert_same_shape(a, b);
+  assert_valid_buffers(a, c);
+  assert(c.shape().rows == 1 and "Buffer must have 1 row");
+  assert(c.shape().cols == 1 and "Buffer must have 1 column");
+#endif
+}
+
+inline void assert_compatible_reduce(
+    [[maybe_unused]] Buffer const &a,
+    [[maybe_unused]] Buffer const &c,
+    [[maybe_unused]] Axis const axis
+)
+{
+#ifndef NDEBUG
+  assert_valid_buffers(a, c);
+  auto const [rows, cols] = reduced_shape(a.shape(), axis);
+  assert(c.shape().rows == rows and "Output buffer rows do not match the reduction axis");
+  assert(c.shape().cols == cols and "Output buffer cols do not match the reduction axis");
+#endif
+}
+
 } // namespace gpu_playground::backend
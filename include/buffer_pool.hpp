@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer.hpp"
+
+namespace gpu_playground::backend
+{
+
+struct PoolStats
+{
+  size_t hits{0};
+  size_t misses{0};
+  size_t bytes_cached{0};
+};
+
+// Keeps the buffers of a device once they are released, so the next request for the same shape
+// skips the backend allocator. Buckets are keyed by shape, which lets backends that store the
+// shape in their handle (Eigen) reuse a buffer as is. Every pooled buffer holds a reference to
+// the pool, so the pool outlives the device if buffers are still around.
+//
+// Threads are spread over shards, each with its own lock and buckets, so that concurrent callers
+// recycling their own buffers do not contend. A buffer goes back to the shard it came from.
+class BufferPool : public std::enable_shared_from_this<BufferPool>
+{
+private:
+  struct Entry
+  {
+    HandlePtr handle;
+    Shape shape;
+  };
+
+  struct alignas(64) Shard
+  {
+    mutable std::mutex mutex;
+    // Every handle the shard has created, whether it is in use or cached.
+    std::unordered_map<void *, Entry> owned;
+    std::map<std::pair<size_t, size_t>, std::vector<void *>> cached;
+    PoolStats counters;
+  };
+
+  static constexpr size_t n_shards{16};
+
+  std::array<Shard, n_shards> shards;
+
+  // Threads take the shards in turn, the first `n_shards` threads get one each.
+  static size_t thread_shard()
+  {
+    static std::atomic<size_t> next{0};
+    thread_local size_t const shard{next++ % n_shards};
+    return shard;
+  }
+
+  void release(size_t const index, void *handle)
+  {
+    auto &shard = this->shards[index];
+    std::lock_guard<std::mutex> const lock(shard.mutex);
+
+    auto const shape = shard.owned.at(handle).shape;
+    shard.cached[{shape.rows, shape.cols}].push_back(handle);
+    shard.counters.bytes_cached += shape.rows * shape.cols * sizeof(float);
+  }
+
+public:
+  // Returns a cached buffer of the given shape, or one created by `make` on a miss.
+  template <class Make>
+  [[nodiscard]] Buffer acquire(Shape const shape, DeviceType const type, Make &&make)
+  {
+    size_t const index = BufferPool::thread_shard();
+    auto &shard        = this->shards[index];
+
+    void *handle{nullptr};
+    {
+      std::lock_guard<std::mutex> const lock(shard.mutex);
+
+      auto &bucket = shard.cached[{shape.rows, shape.cols}];
+      if (bucket.empty())
+      {
+        shard.counters.misses++;
+      }
+      else
+      {
+        handle = bucket.back();
+        bucket.pop_back();
+        shard.counters.hits++;
+        shard.counters.bytes_cached -= shape.rows * shape.cols * sizeof(float);
+      }
+    }
+
+    if (handle == nullptr)
+    {
+      auto owner = std::forward<Make>(make)().take_handle();
+      handle     = owner.get();
+
+      std::lock_guard<std::mutex> const lock(shard.mutex);
+      shard.owned.emplace(handle, Entry{std::move(owner), shape});
+    }
+
+    return Buffer{
+        HandlePtr{
+            handle,
+            [pool = this->shared_from_this(), index](void *ptr) { pool->release(index, ptr); }
+        },
+        shape,
+        type
+    };
+  }
+
+  [[nodiscard]] PoolStats stats() const
+  {
+    PoolStats total;
+    for (auto const &shard : this->shards)
+    {
+      std::lock_guard<std::mutex> const lock(shard.mutex);
+      total.hits         += shard.counters.hits;
+      total.misses       += shard.counters.misses;
+      total.bytes_cached += shard.counters.bytes_cached;
+    }
+    return total;
+  }
+
+  // Frees every cached buffer, buffers in use are not affected.
+  void trim()
+  {
+    for (auto &shard : this->shards)
+    {
+      std::lock_guard<std::mutex> const lock(shard.mutex);
+
+      for (auto &[shape, bucket] : shard.cached)
+      {
+        for (auto *handle : bucket)
+        {
+          shard.owned.erase(handle);
+        }
+      }
+      shard.cached.clear();
+      shard.counters.bytes_cached = 0;
+    }
+  }
+};
+
+} // namespace gpu_playground::backend
@@ -1,20 +1,39 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "buffer.hpp"
+#include "buffer_pool.hpp"
+#include "expression.hpp"
+#include "host_storage.hpp"
+#include "random.hpp"
 
 namespace gpu_playground
 {
 
+// Devices may be shared by threads running independent work: ops keep their scratch space per
+// thread and the pool is sharded per thread. Buffers are not synchronised, a buffer must not be
+// used by one thread while another one writes to it.
 class Device
 {
+private:
+  std::shared_ptr<backend::BufferPool> pool{std::make_shared<backend::BufferPool>()};
+  // 1x1 buffers holding element counts, made on first use, under `counts_mutex`.
+  mutable std::unordered_map<size_t, backend::Buffer> counts;
+  mutable std::mutex counts_mutex;
+
 public:
   virtual ~Device() = default;
 
   [[nodiscard]] virtual DeviceType type() const = 0;
 
+  // The number of threads the device runs an op on, the calling thread included.
+  [[nodiscard]] virtual size_t num_threads() const { return 1; }
+
   virtual void
   add(backend::Buffer const &a, backend::Buffer const &b, backend::Buffer &c) const = 0;
 
@@ -42,11 +61,96 @@ public:
   virtual void
   sdiv(backend::Buffer const &a, backend::Buffer const &b, backend::Buffer &c) const = 0;
 
+  // y = alpha * x + y, with alpha read from a 1x1 buffer.
+  virtual void
+  axpy(backend::Buffer const &alpha, backend::Buffer const &x, backend::Buffer &y) const = 0;
+
+  // y = alpha * x + beta * y, with alpha and beta read from 1x1 buffers.
+  virtual void axpby(
+      backend::Buffer const &alpha,
+      backend::Buffer const &x,
+      backend::Buffer const &beta,
+      backend::Buffer &y
+  ) const = 0;
+
+  virtual void
+  dot(backend::Buffer const &a, backend::Buffer const &b, backend::Buffer &c) const = 0;
+
+  virtual void sum(backend::Buffer const &a, backend::Buffer &c, Axis axis) const = 0;
+
+  virtual void max(backend::Buffer const &a, backend::Buffer &c, Axis axis) const = 0;
+
+  virtual void min(backend::Buffer const &a, backend::Buffer &c, Axis axis) const = 0;
+
+  virtual void norm2(backend::Buffer const &a, backend::Buffer &c, Axis axis) const = 0;
+
+  // Evaluates a fused element-wise expression into `out` in a single pass.
+  virtual void eval(backend::ExprProgram const &program, backend::Buffer &out) const = 0;
+
   [[nodiscard]] virtual backend::Buffer new_buffer(std::vector<float> data, Shape shape) const = 0;
 
+  // Allocates a buffer without initialising it, so outputs that are about to be overwritten
+  // cost no extra pass over memory.
+  [[nodiscard]] virtual backend::Buffer new_buffer_uninitialized(Shape shape) const = 0;
+
   [[nodiscard]] backend::Buffer new_buffer_with_shape(Shape shape) const
   {
-    return this->new_buffer(std::vector<float>(shape.rows * shape.cols, 0.0), shape);
+    auto buffer = this->new_buffer_uninitialized(shape);
+    this->fill(buffer, 0.0F);
+    return buffer;
+  }
+
+  // Returns a buffer recycled through the device pool. Its contents are unspecified, so it is
+  // meant for outputs that are about to be overwritten.
+  [[nodiscard]] backend::Buffer new_pooled_buffer(Shape shape) const
+  {
+    return this->pool->acquire(
+        shape, this->type(), [this, shape]() { return this->new_buffer_uninitialized(shape); }
+    );
+  }
+
+  // Takes over the host storage of a buffer allocated by another CPU device, as a tensor moves to
+  // this one.
+  [[nodiscard]] virtual backend::HandlePtr adopt_host_storage(backend::HandlePtr handle) const
+  {
+    return handle;
+  }
+
+  [[nodiscard]] backend::PoolStats pool_stats() const { return this->pool->stats(); }
+
+  // Frees the buffers cached by the pool.
+  void trim_pool() const { this->pool->trim(); }
+
+  // Returns a 1x1 buffer holding `count`, made once per device and count and shared by every
+  // caller afterwards, so it must only be read.
+  [[nodiscard]] backend::Buffer const &count_buffer(size_t const count) const
+  {
+    std::lock_guard<std::mutex> const lock(this->counts_mutex);
+    auto it = this->counts.find(count);
+    if (it == this->counts.end())
+    {
+      it = this->counts
+               .emplace(count, this->new_buffer({static_cast<float>(count)}, Shape{1, 1}))
+               .first;
+    }
+    return it->second;
+  }
+
+  virtual void fill(backend::Buffer &buffer, float value) const = 0;
+
+  // Fills `buffer` with values drawn from `dist`, the same for a given seed on every device. CPU
+  // devices write their memory in place, the others take values generated on the host.
+  virtual void fill_random(backend::Buffer &buffer, Distribution dist, uint64_t seed) const
+  {
+    if (backend::is_host_device(this->type()))
+    {
+      backend::fill_random(backend::host_ptr(buffer), buffer.size(), dist, seed);
+      return;
+    }
+
+    std::vector<float> data(buffer.size());
+    backend::fill_random(data.data(), data.size(), dist, seed);
+    this->copy_buffer(this->new_buffer(std::move(data), buffer.shape()), buffer);
   }
 
   virtual void copy_buffer(backend::Buffer const &from, backend::Buffer &to) const = 0;
@@ -55,6 +159,9 @@ public:
 
   [[nodiscard]] virtual std::vector<float> cpu(backend::Buffer const &buffer) const = 0;
 
+  // Returns the buffer memory as seen from the host, once the pending work on it has completed.
+  [[nodiscard]] virtual float const *host_data(backend::Buffer const &buffer) const = 0;
+
   virtual void sync(backend::Buffer const &buffer) const = 0;
 };
 
@@ -64,16 +171,46 @@ DevicePtr make_serial_device();
 
 #ifdef GPU_PLAYGROUND_HAS_EIGEN
 DevicePtr make_eigen_device();
+
+// Sets the number of threads Eigen runs matrix products on, or one per core when zero. The count
+// is Eigen's own, shared by every Eigen device, and products only run in parallel when the
+// backend is built with OpenMP. Meant to be set once at startup.
+void set_eigen_threads(size_t num_threads);
+
+[[nodiscard]] size_t eigen_threads();
 #endif
 
 #ifdef GPU_PLAYGROUND_HAS_SIMD
 DevicePtr make_simd_device();
 #endif
 
+#ifdef GPU_PLAYGROUND_HAS_THREADED
+// Runs on `num_threads` threads, or on one per available core when zero.
+DevicePtr make_threaded_device(size_t num_threads = 0);
+#endif
+
+#ifdef GPU_PLAYGROUND_HAS_BLAS
+DevicePtr make_blas_device();
+#endif
+
 #ifdef GPU_PLAYGROUND_HAS_METAL
 DevicePtr make_metal_device();
 #endif
 
+// Runs the ops of the CPU device `device` on a background stream. Ops return once queued, while
+// sync(), cpu() and host_data() wait only for the ops using the buffer they are given.
+DevicePtr make_async_device(DevicePtr device);
+
+// Runs every op on whichever of the CPU devices `devices` is fastest for its kind and size. The
+// devices are timed when an auto device first runs an op, once per process for every set of
+// backends and thread counts, so making the device costs nothing. Buffers stay in the shared host
+// storage, so no data moves between them. The devices must run their ops synchronously: to run in
+// the background, wrap the auto device instead.
+DevicePtr make_auto_device(std::vector<DevicePtr> devices);
+
+// The number of times auto devices have timed a set of backends so far.
+[[nodiscard]] size_t auto_device_calibrations();
+
 inline std::array<DevicePtr, DeviceIdx::COUNT> make_devices()
 {
 
@@ -90,6 +227,28 @@ inline std::array<DevicePtr, DeviceIdx::COUNT> make_devices()
 #else
   devices[DeviceIdx::SIMD] = nullptr;
 #endif
+#ifdef GPU_PLAYGROUND_HAS_THREADED
+  devices[DeviceIdx::THREADED] = make_threaded_device();
+#else
+  devices[DeviceIdx::THREADED] = nullptr;
+#endif
+#ifdef GPU_PLAYGROUND_HAS_BLAS
+  devices[DeviceIdx::BLAS] = make_blas_device();
+#else
+  devices[DeviceIdx::BLAS] = nullptr;
+#endif
+
+  // Every CPU device made so far, which share their buffers with the auto device.
+  std::vector<DevicePtr> host_devices;
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      host_devices.push_back(device);
+    }
+  }
+  devices[DeviceIdx::AUTO] = make_auto_device(std::move(host_devices));
+
 #ifdef GPU_PLAYGROUND_HAS_METAL
   devices[DeviceIdx::METAL] = make_metal_device();
 #else
@@ -11,6 +11,9 @@ namespace gpu_playground
   X(SERIAL)                                                                                        \
   X(EIGEN)                                                                                         \
   X(SIMD)                                                                                          \
+  X(THREADED)                                                                                      \
+  X(BLAS)                                                                                          \
+  X(AUTO)                                                                                          \
   X(METAL)
 
 enum class DeviceType : uint8_t
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "buffer.hpp"
+
+namespace gpu_playground
+{
+
+class Device;
+
+namespace backend
+{
+
+enum class ExprOp : uint8_t
+{
+  LOAD,
+  LOAD_SCALAR,
+  ADD,
+  SUB,
+  MUL,
+  DIV
+};
+
+struct ExprInstr
+{
+  ExprOp op;
+  size_t operand{0};
+};
+
+// A flattened element-wise expression in postfix order. LOAD pushes operands[operand],
+// LOAD_SCALAR pushes the single value of a 1x1 operand, the arithmetic ops pop two values and
+// push the result. Backends evaluate the whole program in one pass over the output.
+struct ExprProgram
+{
+  std::vector<ExprInstr> code;
+  std::vector<Buffer const *> operands;
+  size_t depth{0};
+};
+
+inline void
+assert_compatible_eval([[maybe_unused]] ExprProgram const &program, [[maybe_unused]] Buffer &out)
+{
+#ifndef NDEBUG
+  assert(not program.code.empty() and "Expression is empty");
+  for (auto const &instr : program.code)
+  {
+    if (instr.op == ExprOp::LOAD)
+    {
+      assert_same_shape(*program.operands[instr.operand], out);
+    }
+    else if (instr.op == ExprOp::LOAD_SCALAR)
+    {
+      auto const &scalar = *program.operands[instr.operand];
+      assert_valid_buffers(scalar, out);
+      assert(scalar.shape().rows == 1 and "Buffer must have 1 row");
+      assert(scalar.shape().cols == 1 and "Buffer must have 1 column");
+    }
+  }
+#endif
+}
+
+} // namespace backend
+
+namespace expr
+{
+
+class Leaf;
+class Scalar;
+
+template <backend::ExprOp Op, class L, class R>
+class Binary;
+
+// Expression nodes are cheap to copy: leaves only point at the buffers of live tensors, so an
+// expression must be evaluated before the tensors it references go out of scope.
+template <class Derived>
+class Expr
+{
+public:
+  [[nodiscard]] Derived const &derived() const { return static_cast<Derived const &>(*this); }
+
+  template <class R>
+  [[nodiscard]] Binary<backend::ExprOp::MUL, Derived, R> cmul(Expr<R> const &other) const;
+
+  template <class R>
+  [[nodiscard]] Binary<backend::ExprOp::DIV, Derived, R> cdiv(Expr<R> const &other) const;
+
+  [[nodiscard]] Binary<backend::ExprOp::MUL, Derived, Leaf> cmul(Leaf other) const;
+
+  [[nodiscard]] Binary<backend::ExprOp::DIV, Derived, Leaf> cdiv(Leaf other) const;
+
+  [[nodiscard]] Binary<backend::ExprOp::ADD, Derived, Scalar> sadd(Scalar other) const;
+
+  [[nodiscard]] Binary<backend::ExprOp::SUB, Derived, Scalar> ssub(Scalar other) const;
+
+  [[nodiscard]] Binary<backend::ExprOp::MUL, Derived, Scalar> smul(Scalar other) const;
+
+  [[nodiscard]] Binary<backend::ExprOp::DIV, Derived, Scalar> sdiv(Scalar other) const;
+};
+
+class Leaf : public Expr<Leaf>
+{
+private:
+  backend::Buffer const *buffer;
+  std::shared_ptr<Device> const *device_ptr;
+
+public:
+  Leaf(backend::Buffer const &buffer, std::shared_ptr<Device> const &device)
+      : buffer(&buffer), device_ptr(&device)
+  {
+  }
+
+  [[nodiscard]] Shape shape() const { return this->buffer->shape(); }
+
+  [[nodiscard]] std::shared_ptr<Device> const &device() const { return *this->device_ptr; }
+
+  size_t emit(backend::ExprProgram &program) const
+  {
+    program.code.push_back({backend::ExprOp::LOAD, program.operands.size()});
+    program.operands.push_back(this->buffer);
+    return 1;
+  }
+};
+
+// A 1x1 buffer broadcast over the whole expression, the lazy counterpart of the s* ops.
+class Scalar
+{
+private:
+  backend::Buffer const *buffer;
+
+public:
+  explicit Scalar(backend::Buffer const &buffer) : buffer(&buffer) {}
+
+  size_t emit(backend::ExprProgram &program) const
+  {
+    program.code.push_back({backend::ExprOp::LOAD_SCALAR, program.operands.size()});
+    program.operands.push_back(this->buffer);
+    return 1;
+  }
+};
+
+template <backend::ExprOp Op, class L, class R>
+class Binary : public Expr<Binary<Op, L, R>>
+{
+private:
+  L lhs;
+  R rhs;
+
+public:
+  Binary(L lhs, R rhs) : lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+
+  [[nodiscard]] Shape shape() const { return this->lhs.shape(); }
+
+  [[nodiscard]] std::shared_ptr<Device> const &device() const { return this->lhs.device(); }
+
+  // Returns the stack depth needed to evaluate this node.
+  size_t emit(backend::ExprProgram &program) const
+  {
+    auto const lhs_depth = this->lhs.emit(program);
+    auto const rhs_depth = this->rhs.emit(program);
+    program.code.push_back({Op, 0});
+    return std::max(lhs_depth, rhs_depth + 1);
+  }
+};
+
+template <class Derived>
+template <class R>
+Binary<backend::ExprOp::MUL, Derived, R> Expr<Derived>::cmul(Expr<R> const &other) const
+{
+  return {this->derived(), other.derived()};
+}
+
+template <class Derived>
+template <class R>
+Binary<backend::ExprOp::DIV, Derived, R> Expr<Derived>::cdiv(Expr<R> const &other) const
+{
+  return {this->derived(), other.derived()};
+}
+
+template <class Derived>
+Binary<backend::ExprOp::MUL, Derived, Leaf> Expr<Derived>::cmul(Leaf other) const
+{
+  return {this->derived(), other};
+}
+
+template <class Derived>
+Binary<backend::ExprOp::DIV, Derived, Leaf> Expr<Derived>::cdiv(Leaf other) const
+{
+  return {this->derived(), other};
+}
+
+template <class Derived>
+Binary<backend::ExprOp::ADD, Derived, Scalar> Expr<Derived>::sadd(Scalar other) const
+{
+  return {this->derived(), other};
+}
+
+template <class Derived>
+Binary<backend::ExprOp::SUB, Derived, Scalar> Expr<Derived>::ssub(Scalar other) const
+{
+  return {this->derived(), other};
+}
+
+template <class Derived>
+Binary<backend::ExprOp::MUL, Derived, Scalar> Expr<Derived>::smul(Scalar other) const
+{
+  return {this->derived(), other};
+}
+
+template <class Derived>
+Binary<backend::ExprOp::DIV, Derived, Scalar> Expr<Derived>::sdiv(Scalar other) const
+{
+  return {this->derived(), other};
+}
+
+template <class L, class R>
+Binary<backend::ExprOp::ADD, L, R> operator+(Expr<L> const &lhs, Expr<R> const &rhs)
+{
+  return {lhs.derived(), rhs.derived()};
+}
+
+template <class L, class R>
+Binary<backend::ExprOp::SUB, L, R> operator-(Expr<L> const &lhs, Expr<R> const &rhs)
+{
+  return {lhs.derived(), rhs.derived()};
+}
+
+template <class E>
+backend::ExprProgram compile(Expr<E> const &expression)
+{
+  backend::ExprProgram program;
+  program.depth = expression.derived().emit(program);
+  return program;
+}
+
+} // namespace expr
+
+} // namespace gpu_playground
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "expression.hpp"
+#include "host_storage.hpp"
+
+// The interpreter host backends share to run an ExprProgram, each bringing only the kernel that
+// applies one op to a block.
+namespace gpu_playground::backend
+{
+
+// Expressions are evaluated one block at a time, so intermediate values stay in cache and every
+// operand is streamed from memory exactly once. Blocks are a multiple of the host alignment, which
+// keeps every block start aligned for vector loads.
+inline constexpr size_t eval_block{256};
+
+static_assert((eval_block * sizeof(float)) % host_alignment == 0);
+
+// A value on the evaluation stack: a block of `eval_block` floats, or a broadcast scalar when
+// `data` is null.
+struct EvalSlot
+{
+  float const *data{nullptr};
+  float scalar{0.0F};
+};
+
+// The host memory of the program operands, in the order the program refers to them.
+[[nodiscard]] inline std::vector<float const *> host_operands(ExprProgram const &program)
+{
+  std::vector<float const *> operands;
+  operands.reserve(program.operands.size());
+  for (auto const *operand : program.operands)
+  {
+    operands.push_back(host_ptr(*operand));
+  }
+  return operands;
+}
+
+// Evaluates elements [begin, end) of `program` into `out`, `begin` must be a multiple of the host
+// alignment in floats. `block_op(op, lhs, rhs, dst, len)` applies an arithmetic op to `len`
+// values. The scratch space is kept per thread, so concurrent evaluations neither share nor
+// reallocate it.
+template <class BlockOp>
+void eval_program(
+    ExprProgram const &program,
+    std::vector<float const *> const &operands,
+    float *out,
+    size_t const begin,
+    size_t const end,
+    BlockOp const &block_op
+)
+{
+  struct AlignedDelete
+  {
+    void operator()(float *ptr) const { ::operator delete(ptr, std::align_val_t{host_alignment}); }
+  };
+
+  thread_local std::unique_ptr<float[], AlignedDelete> scratch;
+  thread_local size_t scratch_size{0};
+  thread_local std::vector<EvalSlot> stack;
+  if (scratch_size < program.depth * eval_block)
+  {
+    scratch_size = program.depth * eval_block;
+    scratch.reset(static_cast<float *>(
+        ::operator new(scratch_size * sizeof(float), std::align_val_t{host_alignment})
+    ));
+  }
+  stack.resize(program.depth);
+
+  size_t const last = program.code.size() - 1;
+  for (size_t start{begin}; start < end; start += eval_block)
+  {
+    size_t const len = std::min(eval_block, end - start);
+    float *block_out = &out[start];
+
+    size_t sp{0};
+    for (size_t pc{0}; pc <= last; pc++)
+    {
+      auto const &instr = program.code[pc];
+      switch (instr.op)
+      {
+      case ExprOp::LOAD:
+        stack[sp++] = {&operands[instr.operand][start], 0.0F};
+        break;
+      case ExprOp::LOAD_SCALAR:
+        stack[sp++] = {nullptr, operands[instr.operand][0]};
+        break;
+      default:
+      {
+        sp--;
+        // The last instruction writes straight into the output, the others into scratch.
+        float *dst = pc == last ? block_out : &scratch[(sp - 1) * eval_block];
+        block_op(instr.op, stack[sp - 1], stack[sp], dst, len);
+        stack[sp - 1] = {dst, 0.0F};
+        break;
+      }
+      }
+    }
+
+    // A program made of a single load has no instruction writing the output.
+    auto const &res = stack.front();
+    if (res.data == nullptr)
+    {
+      std::fill_n(block_out, len, res.scalar);
+    }
+    else if (res.data != block_out)
+    {
+      std::copy_n(res.data, len, block_out);
+    }
+  }
+}
+
+} // namespace gpu_playground::backend
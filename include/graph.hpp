@@ -0,0 +1,388 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "device.hpp"
+
+namespace gpu_playground
+{
+
+namespace backend
+{
+
+enum class OpKind : uint8_t
+{
+  ADD,
+  SUB,
+  MUL,
+  CMUL,
+  CDIV,
+  SADD,
+  SSUB,
+  SMUL,
+  SDIV,
+  AXPY,
+  AXPBY,
+  DOT,
+  SUM,
+  MAX,
+  MIN,
+  NORM2,
+  EVAL,
+  COPY,
+  TRANSPOSE
+};
+
+} // namespace backend
+
+// Records the device calls issued by Tensor ops so they can be replayed without re-allocating.
+//
+// While `capture` runs its callable, every op is executed as usual and recorded, and every
+// tensor created lives in memory owned by the graph. When the capture ends, intermediates whose
+// lifetimes do not overlap are packed into the same buffers, and `replay` then reissues the
+// recorded calls on those buffers with no allocation or bookkeeping in between.
+//
+// Tensors created before the capture are used in place: they must not be moved or destroyed
+// while the graph is replayed. Tensors created during the capture point into graph memory and
+// must not outlive the graph, and those created from host data keep their values across replays.
+class Graph
+{
+private:
+  static constexpr size_t none{std::numeric_limits<size_t>::max()};
+
+  struct Slot
+  {
+    backend::Buffer const *external{nullptr};
+    size_t buffer{none};
+    Shape shape{};
+    bool constant{false};
+    size_t first{none};
+    size_t last{0};
+  };
+
+  struct Node
+  {
+    backend::OpKind kind;
+    Axis axis;
+    std::array<size_t, 3> inputs;
+    size_t n_inputs;
+    size_t output;
+    std::vector<size_t> operands;
+    backend::ExprProgram program;
+    std::array<backend::Buffer const *, 3> in{};
+    backend::Buffer *out{nullptr};
+  };
+
+  DevicePtr device;
+  std::vector<backend::Buffer> buffers;
+  std::vector<Slot> slots;
+  std::vector<Node> nodes;
+  std::unordered_map<void const *, size_t> slot_of;
+  // Cleared by the handle deleter of a graph-owned tensor, so the plan knows which
+  // intermediates are still referenced once the capture ends.
+  std::shared_ptr<std::vector<bool>> referenced{std::make_shared<std::vector<bool>>()};
+
+  // Graph-owned buffers are looked up by handle, since tensors only hold an alias to them. Other
+  // buffers are looked up by address: tensors sharing memory get a slot each, and a tensor whose
+  // buffer is replaced keeps its slot.
+  size_t slot(backend::Buffer const &buffer)
+  {
+    auto const owned = this->slot_of.find(buffer.get());
+    if (owned != this->slot_of.end())
+    {
+      return owned->second;
+    }
+
+    auto const [it, inserted] = this->slot_of.try_emplace(&buffer, this->slots.size());
+    if (inserted)
+    {
+      this->slots.push_back(Slot{&buffer, none, buffer.shape()});
+      this->referenced->push_back(true);
+    }
+    return it->second;
+  }
+
+  void use(size_t const slot, size_t const node)
+  {
+    auto &info = this->slots[slot];
+    info.first = std::min(info.first, node);
+    info.last  = node;
+  }
+
+  [[nodiscard]] backend::Buffer const *resolve(size_t const slot) const
+  {
+    auto const &info = this->slots[slot];
+    return info.external != nullptr ? info.external : &this->buffers[info.buffer];
+  }
+
+  // Greedy interval packing: walking the nodes in order, an intermediate takes a free buffer of
+  // the same shape when it is first written and gives it back after its last use. Constants and
+  // tensors still referenced after the capture keep the buffer they were created with.
+  void plan()
+  {
+    size_t const n_nodes = this->nodes.size();
+    std::vector<std::vector<size_t>> starts(n_nodes);
+    std::vector<std::vector<size_t>> ends(n_nodes);
+    std::vector<size_t> where(this->slots.size(), none);
+    std::vector<backend::Buffer> planned;
+
+    for (size_t s{0}; s < this->slots.size(); s++)
+    {
+      auto const &info = this->slots[s];
+      if (info.external != nullptr)
+      {
+        continue;
+      }
+
+      if (info.constant or (*this->referenced)[s])
+      {
+        where[s] = planned.size();
+        planned.push_back(std::move(this->buffers[info.buffer]));
+      }
+      else if (info.first != none)
+      {
+        starts[info.first].push_back(s);
+        ends[info.last].push_back(s);
+      }
+    }
+
+    std::vector<size_t> free;
+    for (size_t n{0}; n < n_nodes; n++)
+    {
+      for (auto const s : starts[n])
+      {
+        auto const &info = this->slots[s];
+        auto const reuse = std::find_if(
+            free.begin(),
+            free.end(),
+            [&](size_t const idx)
+            {
+              auto const shape = planned[idx].shape();
+              return shape.rows == info.shape.rows and shape.cols == info.shape.cols;
+            }
+        );
+
+        if (reuse != free.end())
+        {
+          where[s] = *reuse;
+          free.erase(reuse);
+        }
+        else
+        {
+          where[s] = planned.size();
+          planned.push_back(std::move(this->buffers[info.buffer]));
+        }
+      }
+
+      for (auto const s : ends[n])
+      {
+        free.push_back(where[s]);
+      }
+    }
+
+    for (size_t s{0}; s < this->slots.size(); s++)
+    {
+      this->slots[s].buffer = where[s];
+    }
+    this->buffers = std::move(planned);
+
+    for (auto &node : this->nodes)
+    {
+      for (size_t i{0}; i < node.n_inputs; i++)
+      {
+        node.in[i] = this->resolve(node.inputs[i]);
+      }
+      // Outputs are never const: they are either graph-owned or the buffer of a mutable tensor.
+      node.out = const_cast<backend::Buffer *>(this->resolve(node.output));
+      for (size_t i{0}; i < node.operands.size(); i++)
+      {
+        node.program.operands[i] = this->resolve(node.operands[i]);
+      }
+    }
+    this->slot_of.clear();
+  }
+
+public:
+  Graph()                         = default;
+  ~Graph()                        = default;
+  Graph(Graph const &)            = delete;
+  Graph &operator=(Graph const &) = delete;
+  Graph(Graph &&)                 = default;
+  Graph &operator=(Graph &&)      = default;
+
+  // The graph currently recording on this thread, if any.
+  static Graph *&capturing()
+  {
+    thread_local Graph *graph{nullptr};
+    return graph;
+  }
+
+  // Runs `ops` once while recording them, then plans the buffers for `replay`.
+  template <class F>
+  void capture(F &&ops)
+  {
+    assert(Graph::capturing() == nullptr and "Captures cannot be nested");
+    assert(this->nodes.empty() and "Graph has already been captured");
+
+    Graph::capturing() = this;
+    std::forward<F>(ops)();
+    Graph::capturing() = nullptr;
+
+    this->plan();
+  }
+
+  // Takes ownership of a buffer created during the capture and returns a handle to it that
+  // does not free the memory.
+  [[nodiscard]] backend::Buffer adopt(backend::Buffer buffer, bool const constant)
+  {
+    auto const slot  = this->slots.size();
+    auto const shape = buffer.shape();
+    auto const type  = buffer.device_type();
+    void *handle     = buffer.get();
+
+    this->slot_of[handle] = slot;
+    this->slots.push_back(Slot{nullptr, this->buffers.size(), shape, constant});
+    this->referenced->push_back(true);
+    this->buffers.push_back(std::move(buffer));
+
+    return {
+        backend::HandlePtr(
+            handle, [referenced = this->referenced, slot](void *) { (*referenced)[slot] = false; }
+        ),
+        shape,
+        type
+    };
+  }
+
+  void record(
+      DevicePtr const &device,
+      backend::OpKind const kind,
+      std::initializer_list<backend::Buffer const *> inputs,
+      backend::Buffer const &output,
+      Axis const axis = Axis::ALL
+  )
+  {
+    assert(
+        (this->device == nullptr or this->device == device) and
+        "All captured ops must run on the same device"
+    );
+    assert(inputs.size() <= 3 and "Too many inputs");
+    this->device = device;
+
+    size_t const n = this->nodes.size();
+    Node node{kind, axis, {}, inputs.size(), this->slot(output), {}, {}};
+    size_t i{0};
+    for (auto const *input : inputs)
+    {
+      node.inputs[i] = this->slot(*input);
+      this->use(node.inputs[i++], n);
+    }
+    this->use(node.output, n);
+    this->nodes.push_back(std::move(node));
+  }
+
+  void record(
+      DevicePtr const &device, backend::ExprProgram const &program, backend::Buffer const &output
+  )
+  {
+    this->record(device, backend::OpKind::EVAL, {}, output);
+
+    auto &node   = this->nodes.back();
+    node.program = program;
+    for (auto const *operand : program.operands)
+    {
+      node.operands.push_back(this->slot(*operand));
+      this->use(node.operands.back(), this->nodes.size() - 1);
+    }
+  }
+
+  [[nodiscard]] size_t size() const { return this->nodes.size(); }
+
+  // Number of buffers the graph owns after planning, a measure of how much memory is reused.
+  [[nodiscard]] size_t num_buffers() const { return this->buffers.size(); }
+
+  void replay() const
+  {
+    assert(Graph::capturing() == nullptr and "Cannot replay while capturing");
+
+    using backend::OpKind;
+    auto const &dev = *this->device;
+
+    for (auto const &node : this->nodes)
+    {
+      auto const &in = node.in;
+      auto &out      = *node.out;
+
+      switch (node.kind)
+      {
+      case OpKind::ADD:
+        dev.add(*in[0], *in[1], out);
+        break;
+      case OpKind::SUB:
+        dev.sub(*in[0], *in[1], out);
+        break;
+      case OpKind::MUL:
+        dev.mul(*in[0], *in[1], out);
+        break;
+      case OpKind::CMUL:
+        dev.cmul(*in[0], *in[1], out);
+        break;
+      case OpKind::CDIV:
+        dev.cdiv(*in[0], *in[1], out);
+        break;
+      case OpKind::SADD:
+        dev.sadd(*in[0], *in[1], out);
+        break;
+      case OpKind::SSUB:
+        dev.ssub(*in[0], *in[1], out);
+        break;
+      case OpKind::SMUL:
+        dev.smul(*in[0], *in[1], out);
+        break;
+      case OpKind::SDIV:
+        dev.sdiv(*in[0], *in[1], out);
+        break;
+      case OpKind::AXPY:
+        dev.axpy(*in[0], *in[1], out);
+        break;
+      case OpKind::AXPBY:
+        dev.axpby(*in[0], *in[1], *in[2], out);
+        break;
+      case OpKind::DOT:
+        dev.dot(*in[0], *in[1], out);
+        break;
+      case OpKind::SUM:
+        dev.sum(*in[0], out, node.axis);
+        break;
+      case OpKind::MAX:
+        dev.max(*in[0], out, node.axis);
+        break;
+      case OpKind::MIN:
+        dev.min(*in[0], out, node.axis);
+        break;
+      case OpKind::NORM2:
+        dev.norm2(*in[0], out, node.axis);
+        break;
+      case OpKind::EVAL:
+        dev.eval(node.program, out);
+        break;
+      case OpKind::COPY:
+        dev.copy_buffer(*in[0], out);
+        break;
+      case OpKind::TRANSPOSE:
+        dev.transpose(*in[0], out);
+        break;
+      }
+    }
+  }
+};
+
+} // namespace gpu_playground
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "buffer.hpp"
+#include "host_storage.hpp"
+#include "reproducible.hpp"
+
+namespace gpu_playground::backend
+{
+
+// The Device ops over host storage as inline static functions, for BasicTensor: with the backend
+// known at compile time every op is a direct call the compiler can inline, which matters more
+// than the kernel itself for small buffers. The loops are kept simple so they auto-vectorise.
+class HostKernels
+{
+private:
+  template <class Op>
+  static void cwisem_op(Buffer const &a, Buffer const &b, Buffer &c, Op const &op)
+  {
+    assert_same_shape(a, b, c);
+
+    auto const *host_a = host_ptr(a);
+    auto const *host_b = host_ptr(b);
+    auto *host_c       = host_ptr(c);
+
+    for (size_t i{0}; i < a.size(); i++)
+    {
+      host_c[i] = op(host_a[i], host_b[i]);
+    }
+  }
+
+  template <class Op>
+  static void cwises_op(Buffer const &a, Buffer const &b, Buffer &c, Op const &op)
+  {
+    assert_compatible_sop(a, b, c);
+
+    auto const *host_a  = host_ptr(a);
+    auto const scalar_b = host_ptr(b)[0];
+    auto *host_c        = host_ptr(c);
+
+    for (size_t i{0}; i < a.size(); i++)
+    {
+      host_c[i] = op(host_a[i], scalar_b);
+    }
+  }
+
+  template <class Op, class Finalize>
+  static void reduce_op(
+      Buffer const &a,
+      Buffer &c,
+      Axis const axis,
+      float const init,
+      Op const &op,
+      Finalize const &finalize
+  )
+  {
+    assert_compatible_reduce(a, c, axis);
+
+    auto const *host_a      = host_ptr(a);
+    auto *host_c            = host_ptr(c);
+    auto const [rows, cols] = a.shape();
+
+    switch (axis)
+    {
+    case Axis::ROWS:
+      for (size_t i{0}; i < rows; i++)
+      {
+        float acc{init};
+        for (size_t j{0}; j < cols; j++)
+        {
+          acc = op(acc, host_a[(i * cols) + j]);
+        }
+        host_c[i] = finalize(acc);
+      }
+      break;
+    case Axis::COLS:
+      std::fill_n(host_c, cols, init);
+      for (size_t i{0}; i < rows; i++)
+      {
+        for (size_t j{0}; j < cols; j++)
+        {
+          host_c[j] = op(host_c[j], host_a[(i * cols) + j]);
+        }
+      }
+      for (size_t j{0}; j < cols; j++)
+      {
+        host_c[j] = finalize(host_c[j]);
+      }
+      break;
+    case Axis::ALL:
+    {
+      float acc{init};
+      for (size_t i{0}; i < a.size(); i++)
+      {
+        acc = op(acc, host_a[i]);
+      }
+      host_c[0] = finalize(acc);
+      break;
+    }
+    }
+  }
+
+  [[nodiscard]] static float identity(float const x) { return x; }
+
+public:
+  // Buffers are tagged as serial ones, which share the same host storage.
+  static constexpr DeviceType s_type{DeviceType::SERIAL};
+
+  [[nodiscard]] static Buffer new_buffer_uninitialized(Shape const shape)
+  {
+    return {new_host_storage(shape.rows * shape.cols), shape, HostKernels::s_type};
+  }
+
+  static void add(Buffer const &a, Buffer const &b, Buffer &c)
+  {
+    cwisem_op(a, b, c, [](float const x, float const y) { return x + y; });
+  }
+
+  static void sub(Buffer const &a, Buffer const &b, Buffer &c)
+  {
+    cwisem_op(a, b, c, [](float const x, float const y) { return x - y; });
+  }
+
+  static void mul(Buffer const &a, Buffer const &b, Buffer &c)
+  {
+    assert_compatible_mul(a, b, c);
+
+    auto const *host_a = host_ptr(a);
+    auto const *host_b = host_ptr(b);
+    auto *host_c       = host_ptr(c);
+
+    auto const [m, k] = a.shape();
+    auto const n      = b.shape().cols;
+
+    std::fill_n(host_c, c.size(), 0.0F);
+    for (size_t i{0}; i < m; i++)
+    {
+      for (size_t p{0}; p < k; p++)
+      {
+        auto const a_ip = host_a[(i * k) + p];
+        for (size_t j{0}; j < n; j++)
+        {
+          host_c[(i * n) + j] += a_ip * host_b[(p * n) + j];
+        }
+      }
+    }
+  }
+
+  static void cmul(Buffer const &a, Buffer const &b, Buffer &c)
+  {
+    cwisem_op(a, b, c, [](float const x, float const y) { return x * y; });
+  }
+
+  static void cdiv(Buffer const &a, Buffer const &b, Buffer &c)
+  {
+    cwisem_op(a, b, c, [](float const x, float const y) { return x / y; });
+  }
+
+  static void sadd(Buffer const &a, Buffer const &b, Buffer &c)
+  {
+    cwises_op(a, b, c, [](float const x, float const y) { return x + y; });
+  }
+
+  static void ssub(Buffer const &a, Buffer const &b, Buffer &c)
+  {
+    cwises_op(a, b, c, [](float const x, float const y) { return x - y; });
+  }
+
+  static void smul(Buffer const &a, Buffer const &b, Buffer &c)
+  {
+    cwises_op(a, b, c, [](float const x, float const y) { return x * y; });
+  }
+
+  static void sdiv(Buffer const &a, Buffer const &b, Buffer &c)
+  {
+    cwises_op(a, b, c, [](float const x, float const y) { return x / y; });
+  }
+
+  static void axpy(Buffer const &alpha, Buffer const &x, Buffer &y)
+  {
+    assert_compatible_axpy(alpha, x, y);
+
+    auto const scalar_alpha = host_ptr(alpha)[0];
+    auto const *host_x      = host_ptr(x);
+    auto *host_y            = host_ptr(y);
+
+    for (size_t i{0}; i < y.size(); i++)
+    {
+      host_y[i] += scalar_alpha * host_x[i];
+    }
+  }
+
+  static void axpby(Buffer const &alpha, Buffer const &x, Buffer const &beta, Buffer &y)
+  {
+    assert_compatible_axpy(alpha, x, y);
+    assert_compatible_axpy(beta, x, y);
+
+    auto const scalar_alpha = host_ptr(alpha)[0];
+    auto const scalar_beta  = host_ptr(beta)[0];
+    auto const *host_x      = host_ptr(x);
+    auto *host_y            = host_ptr(y);
+
+    for (size_t i{0}; i < y.size(); i++)
+    {
+      host_y[i] = (scalar_alpha * host_x[i]) + (scalar_beta * host_y[i]);
+    }
+  }
+
+  static void dot(Buffer const &a, Buffer const &b, Buffer &c)
+  {
+    if (reproducible_reductions())
+    {
+      reproducible::dot(a, b, c);
+      return;
+    }
+
+    assert_compatible_dot(a, b, c);
+
+    auto const *host_a = host_ptr(a);
+    auto const *host_b = host_ptr(b);
+
+    float acc{0.0F};
+    for (size_t i{0}; i < a.size(); i++)
+    {
+      acc += host_a[i] * host_b[i];
+    }
+    host_ptr(c)[0] = acc;
+  }
+
+  static void sum(Buffer const &a, Buffer &c, Axis const axis)
+  {
+    if (reproducible_reductions())
+    {
+      reproducible::reduce<reproducible::Sum>(a, c, axis);
+      return;
+    }
+
+    reduce_op(
+        a, c, axis, 0.0F, [](float const acc, float const x) { return acc + x; }, identity
+    );
+  }
+
+  static void max(Buffer const &a, Buffer &c, Axis const axis)
+  {
+    if (reproducible_reductions())
+    {
+      reproducible::reduce<reproducible::Max>(a, c, axis);
+      return;
+    }
+
+    reduce_op(
+        a,
+        c,
+        axis,
+        -std::numeric_limits<float>::infinity(),
+        [](float const acc, float const x) { return std::max(acc, x); },
+        identity
+    );
+  }
+
+  static void min(Buffer const &a, Buffer &c, Axis const axis)
+  {
+    if (reproducible_reductions())
+    {
+      reproducible::reduce<reproducible::Min>(a, c, axis);
+      return;
+    }
+
+    reduce_op(
+        a,
+        c,
+        axis,
+        std::numeric_limits<float>::infinity(),
+        [](float const acc, float const x) { return std::min(acc, x); },
+        identity
+    );
+  }
+
+  static void norm2(Buffer const &a, Buffer &c, Axis const axis)
+  {
+    if (reproducible_reductions())
+    {
+      reproducible::reduce<reproducible::Norm2>(a, c, axis);
+      return;
+    }
+
+    reduce_op(
+        a,
+        c,
+        axis,
+        0.0F,
+        [](float const acc, float const x) { return acc + (x * x); },
+        [](float const acc) { return std::sqrt(acc); }
+    );
+  }
+
+  static void fill(Buffer &buffer, float const value)
+  {
+    assert_compatible_fill(buffer);
+    std::fill_n(host_ptr(buffer), buffer.size(), value);
+  }
+
+  static void copy_buffer(Buffer const &from, Buffer &to)
+  {
+    assert_compatible_copy(from, to);
+    std::copy_n(host_ptr(from), from.size(), host_ptr(to));
+  }
+
+  static void transpose(Buffer const &from, Buffer &to)
+  {
+    assert_compatible_transpose(from, to);
+
+    auto const *host_from   = host_ptr(from);
+    auto *host_to           = host_ptr(to);
+    auto const [rows, cols] = from.shape();
+
+    for (size_t i{0}; i < rows; i++)
+    {
+      for (size_t j{0}; j < cols; j++)
+      {
+        host_to[(j * rows) + i] = host_from[(i * cols) + j];
+      }
+    }
+  }
+};
+
+} // namespace gpu_playground::backend
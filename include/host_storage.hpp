@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "buffer.hpp"
+
+namespace gpu_playground::backend
+{
+
+// The CPU backends all store a buffer as one row-major array of floats, aligned to
+// `host_alignment` bytes and pointed to directly by the buffer handle. Since the layout is the
+// same, a buffer can change CPU device without touching its memory.
+inline constexpr size_t host_alignment{64};
+
+constexpr bool is_host_device(DeviceType const type)
+{
+  switch (type)
+  {
+  case DeviceType::SERIAL:
+  case DeviceType::EIGEN:
+  case DeviceType::SIMD:
+  case DeviceType::THREADED:
+  case DeviceType::BLAS:
+  case DeviceType::AUTO:
+    return true;
+  default:
+    return false;
+  }
+}
+
+inline constexpr size_t huge_page_size{size_t{2} << 20};
+
+// Where the pages of large buffers go on a host with several NUMA nodes. A page is placed on the
+// node of the thread that first writes to it, unless a policy says otherwise.
+enum class NumaPolicy : uint8_t
+{
+  // Pages are placed by their first write, on the allocating thread when buffers are prefaulted.
+  DEFAULT,
+  // The device touches the pages of a new buffer with the same split of the work its kernels
+  // use, so every thread of a multithreaded device finds its share of the buffer on its own node.
+  // Single-threaded devices leave the pages to their first write.
+  FIRST_TOUCH,
+  // Pages are spread round-robin over the nodes, which balances the traffic over every memory
+  // controller whatever thread touches them.
+  INTERLEAVE
+};
+
+struct HostStorageConfig
+{
+  // Buffers of at least this many bytes are backed by 2 MiB pages where the OS allows it.
+  size_t huge_page_threshold{size_t{32} << 20};
+  // Ask for explicit huge pages (MAP_HUGETLB) before transparent ones. They come from a pool the
+  // administrator reserves, when the pool is empty the allocation falls back to the default.
+  bool explicit_huge_pages{false};
+  // Touch every page of large buffers at allocation, so the first op on them does not pay the
+  // page faults.
+  bool prefault{false};
+  // Applies to the buffers that are large by the threshold above.
+  NumaPolicy numa{NumaPolicy::DEFAULT};
+};
+
+struct HostStorageStats
+{
+  size_t buffers{0};
+  // Large buffers given 2 MiB pages, for transparent ones this counts the requests the kernel
+  // accepted, it may still back part of a buffer with 4 KiB pages.
+  size_t huge_page_buffers{0};
+  size_t prefaulted_buffers{0};
+  // Large buffers touched by their device, under NumaPolicy::FIRST_TOUCH.
+  size_t first_touch_buffers{0};
+  // Large buffers the kernel accepted to interleave, under NumaPolicy::INTERLEAVE.
+  size_t interleaved_buffers{0};
+};
+
+// Applies to the buffers allocated after the change, meant to be set once at startup.
+inline HostStorageConfig &host_storage_config()
+{
+  static HostStorageConfig config;
+  return config;
+}
+
+namespace detail
+{
+
+struct HostStorageCounters
+{
+  std::atomic<size_t> buffers{0};
+  std::atomic<size_t> huge_page_buffers{0};
+  std::atomic<size_t> prefaulted_buffers{0};
+  std::atomic<size_t> first_touch_buffers{0};
+  std::atomic<size_t> interleaved_buffers{0};
+};
+
+inline HostStorageCounters &host_storage_counters()
+{
+  static HostStorageCounters counters;
+  return counters;
+}
+
+#if defined(__linux__)
+// Maps `bytes` rounded up to whole huge pages, at an address aligned to a huge page so that the
+// kernel can back all of it with 2 MiB pages. Returns null if the mapping fails.
+inline void *map_huge(size_t const bytes, HostStorageConfig const &config, bool &huge)
+{
+  int const prot  = PROT_READ | PROT_WRITE;
+  int const flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+  if (config.explicit_huge_pages)
+  {
+    void *ptr = mmap(nullptr, bytes, prot, flags | MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED)
+    {
+      huge = true;
+      return ptr;
+    }
+  }
+
+  void *raw = mmap(nullptr, bytes + huge_page_size, prot, flags, -1, 0);
+  if (raw == MAP_FAILED)
+  {
+    return nullptr;
+  }
+
+  auto const start   = reinterpret_cast<uintptr_t>(raw);
+  auto const aligned = (start + huge_page_size - 1) & ~(huge_page_size - 1);
+  if (aligned > start)
+  {
+    munmap(raw, aligned - start);
+  }
+  munmap(reinterpret_cast<void *>(aligned + bytes), start + huge_page_size - aligned);
+
+  void *ptr = reinterpret_cast<void *>(aligned);
+  huge      = madvise(ptr, bytes, MADV_HUGEPAGE) == 0;
+  return ptr;
+}
+
+// Interleaves the pages of a mapping over the nodes the process may allocate from. Calls the
+// kernel directly, so that libnuma is not needed.
+inline bool interleave(void *ptr, size_t const bytes)
+{
+  constexpr int mpol_interleave{3};
+  constexpr unsigned long mpol_f_mems_allowed{1UL << 2};
+  constexpr unsigned long max_node{1024};
+
+  std::array<unsigned long, max_node / (8 * sizeof(unsigned long))> nodes{};
+  if (syscall(SYS_get_mempolicy, nullptr, nodes.data(), max_node, nullptr, mpol_f_mems_allowed) !=
+      0)
+  {
+    return false;
+  }
+  return syscall(SYS_mbind, ptr, bytes, mpol_interleave, nodes.data(), max_node, 0) == 0;
+}
+#endif
+
+} // namespace detail
+
+[[nodiscard]] inline HostStorageStats host_storage_stats()
+{
+  auto const &counters = detail::host_storage_counters();
+  return {
+      counters.buffers,
+      counters.huge_page_buffers,
+      counters.prefaulted_buffers,
+      counters.first_touch_buffers,
+      counters.interleaved_buffers
+  };
+}
+
+// Writes to every page of `size` floats from `data`, so that they are faulted in, and placed, by
+// the calling thread.
+inline void prefault(float *data, size_t const size)
+{
+  constexpr size_t page_floats{4096 / sizeof(float)};
+  for (size_t offset{0}; offset < size; offset += page_floats)
+  {
+    data[offset] = 0.0F;
+  }
+}
+
+// Touches the pages of a new buffer, given its memory and size in floats.
+using FirstTouch = std::function<void(float *, size_t)>;
+
+// Allocates host storage for `size` floats, left uninitialised. Under NumaPolicy::FIRST_TOUCH,
+// large buffers are handed to `first_touch`, when given, instead of being prefaulted.
+[[nodiscard]] inline HandlePtr
+new_host_storage(size_t const size, FirstTouch const &first_touch = {})
+{
+  auto const &config = host_storage_config();
+  auto &counters     = detail::host_storage_counters();
+  auto const bytes   = std::max<size_t>(size, 1) * sizeof(float);
+  counters.buffers++;
+
+  bool const large = bytes >= config.huge_page_threshold;
+  HandlePtr handle;
+
+#if defined(__linux__)
+  if (large)
+  {
+    auto const mapped = ((bytes + huge_page_size - 1) / huge_page_size) * huge_page_size;
+    bool huge{false};
+    void *ptr = detail::map_huge(mapped, config, huge);
+    if (ptr != nullptr)
+    {
+      counters.huge_page_buffers += huge ? 1 : 0;
+      if (config.numa == NumaPolicy::INTERLEAVE and detail::interleave(ptr, mapped))
+      {
+        counters.interleaved_buffers++;
+      }
+      handle = HandlePtr{ptr, [mapped](void *ptr) -> void { munmap(ptr, mapped); }};
+    }
+  }
+#endif
+
+  if (handle == nullptr)
+  {
+    handle = HandlePtr{
+        ::operator new(bytes, std::align_val_t{host_alignment}),
+        [](void *ptr) -> void { ::operator delete(ptr, std::align_val_t{host_alignment}); }
+    };
+  }
+  auto *data = static_cast<float *>(handle.get());
+  std::uninitialized_default_construct_n(data, size);
+
+  if (large and config.numa == NumaPolicy::FIRST_TOUCH)
+  {
+    if (first_touch)
+    {
+      first_touch(data, size);
+      counters.first_touch_buffers++;
+    }
+  }
+  else if (large and config.prefault)
+  {
+    prefault(data, size);
+    counters.prefaulted_buffers++;
+  }
+
+  return handle;
+}
+
+[[nodiscard]] inline float *host_ptr(Buffer &buffer) { return static_cast<float *>(buffer.get()); }
+
+[[nodiscard]] inline float const *host_ptr(Buffer const &buffer)
+{
+  return static_cast<float const *>(buffer.get());
+}
+
+} // namespace gpu_playground::backend
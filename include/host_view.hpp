@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+#include "shape.hpp"
+
+namespace gpu_playground
+{
+
+// A read-only window on the host memory of a tensor. It does not own the memory, so it is only
+// valid while the tensor is alive, and it sees later writes only after the tensor is synced.
+class HostView
+{
+private:
+  float const *m_data;
+  Shape m_shape;
+
+public:
+  HostView(float const *data, Shape shape) : m_data(data), m_shape(shape) {}
+
+  [[nodiscard]] float const *data() const { return this->m_data; }
+
+  [[nodiscard]] Shape shape() const { return this->m_shape; }
+
+  [[nodiscard]] size_t size() const { return this->m_shape.rows * this->m_shape.cols; }
+
+  [[nodiscard]] float const *begin() const { return this->m_data; }
+
+  [[nodiscard]] float const *end() const { return this->m_data + this->size(); }
+
+  [[nodiscard]] float operator[](size_t const idx) const
+  {
+    assert(idx < this->size() and "Index out of bounds");
+    return this->m_data[idx];
+  }
+
+  [[nodiscard]] float operator()(size_t const row, size_t const col) const
+  {
+    assert(row < this->m_shape.rows and col < this->m_shape.cols and "Index out of bounds");
+    return this->m_data[(row * this->m_shape.cols) + col];
+  }
+};
+
+} // namespace gpu_playground
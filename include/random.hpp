@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace gpu_playground
+{
+
+struct Distribution
+{
+  enum class Kind : uint8_t
+  {
+    UNIFORM,
+    NORMAL
+  };
+
+  Kind kind;
+  // The bounds [a, b) of a uniform distribution, the mean and standard deviation of a normal one.
+  float a;
+  float b;
+
+  static constexpr Distribution uniform(float const min = 0.0F, float const max = 1.0F)
+  {
+    return {Kind::UNIFORM, min, max};
+  }
+
+  static constexpr Distribution normal(float const mean = 0.0F, float const stddev = 1.0F)
+  {
+    return {Kind::NORMAL, mean, stddev};
+  }
+};
+
+namespace backend
+{
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"). The output is a
+// pure function of the seed and of a counter, here the index of a block of four values: any
+// range of a buffer can be generated independently, in any order and on any number of threads,
+// and the result only depends on the seed.
+class Philox
+{
+private:
+  static constexpr uint32_t m0{0xD2511F53};
+  static constexpr uint32_t m1{0xCD9E8D57};
+  static constexpr uint32_t w0{0x9E3779B9};
+  static constexpr uint32_t w1{0xBB67AE85};
+  static constexpr size_t rounds{10};
+
+  uint32_t k0;
+  uint32_t k1;
+
+public:
+  explicit constexpr Philox(uint64_t const seed)
+      : k0(static_cast<uint32_t>(seed)), k1(static_cast<uint32_t>(seed >> 32))
+  {
+  }
+
+  [[nodiscard]] constexpr std::array<uint32_t, 4> operator()(uint64_t const block) const
+  {
+    std::array<uint32_t, 4> c{static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32)};
+    uint32_t key0 = this->k0;
+    uint32_t key1 = this->k1;
+
+    for (size_t r{0}; r < rounds; r++)
+    {
+      uint64_t const p0 = static_cast<uint64_t>(m0) * c[0];
+      uint64_t const p1 = static_cast<uint64_t>(m1) * c[2];
+
+      c = {
+          static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ key0,
+          static_cast<uint32_t>(p1),
+          static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ key1,
+          static_cast<uint32_t>(p0)
+      };
+      key0 += w0;
+      key1 += w1;
+    }
+
+    return c;
+  }
+
+  // Blocks [first, first + Lanes) at once, word `w` of block `first + l` in `[w][l]`. Every round
+  // runs on all the lanes in loops the compiler vectorises.
+  template <size_t Lanes>
+  [[nodiscard]] std::array<std::array<uint32_t, Lanes>, 4> batch(uint64_t const first) const
+  {
+    std::array<std::array<uint32_t, Lanes>, 4> c{};
+    for (size_t l{0}; l < Lanes; l++)
+    {
+      c[0][l] = static_cast<uint32_t>(first + l);
+      c[1][l] = static_cast<uint32_t>((first + l) >> 32);
+    }
+    uint32_t key0 = this->k0;
+    uint32_t key1 = this->k1;
+
+    for (size_t r{0}; r < rounds; r++)
+    {
+      for (size_t l{0}; l < Lanes; l++)
+      {
+        uint64_t const p0 = static_cast<uint64_t>(m0) * c[0][l];
+        uint64_t const p1 = static_cast<uint64_t>(m1) * c[2][l];
+
+        c[0][l] = static_cast<uint32_t>(p1 >> 32) ^ c[1][l] ^ key0;
+        c[1][l] = static_cast<uint32_t>(p1);
+        c[2][l] = static_cast<uint32_t>(p0 >> 32) ^ c[3][l] ^ key1;
+        c[3][l] = static_cast<uint32_t>(p0);
+      }
+      key0 += w0;
+      key1 += w1;
+    }
+
+    return c;
+  }
+};
+
+// Maps 32 random bits to [0, 1) using the 24 bits a float can represent exactly.
+constexpr float to_unit(uint32_t const bits)
+{
+  return static_cast<float>(bits >> 8) * 0x1p-24F;
+}
+
+// The number of blocks of four values fill_random_blocks generates at once.
+inline constexpr size_t random_lanes{16};
+
+// Fills the values of blocks [first, last) of a buffer of `size` values.
+inline void fill_random_blocks(
+    float *data,
+    size_t const size,
+    size_t const first,
+    size_t const last,
+    Distribution const dist,
+    Philox const &philox
+)
+{
+  constexpr float two_pi{6.283185307179586F};
+
+  size_t const end = std::min(last * 4, size);
+  for (size_t block{first}; block < last; block += random_lanes)
+  {
+    // A batch may run past `last`: the blocks are independent, the extra ones are dropped.
+    auto const bits = philox.batch<random_lanes>(block);
+    std::array<std::array<float, random_lanes>, 4> values{};
+
+    if (dist.kind == Distribution::Kind::UNIFORM)
+    {
+      for (size_t w{0}; w < 4; w++)
+      {
+        for (size_t l{0}; l < random_lanes; l++)
+        {
+          values[w][l] = std::fma(dist.b - dist.a, to_unit(bits[w][l]), dist.a);
+        }
+      }
+    }
+    else
+    {
+      // Box-Muller, two normal values from every pair of uniform ones. The first uniform value
+      // is shifted to (0, 1] so that the logarithm stays finite.
+      for (size_t w{0}; w < 4; w += 2)
+      {
+        for (size_t l{0}; l < random_lanes; l++)
+        {
+          float const radius = std::sqrt(-2.0F * std::log(1.0F - to_unit(bits[w][l])));
+          float const theta  = two_pi * to_unit(bits[w + 1][l]);
+          values[w][l]       = std::fma(dist.b, radius * std::cos(theta), dist.a);
+          values[w + 1][l]   = std::fma(dist.b, radius * std::sin(theta), dist.a);
+        }
+      }
+    }
+
+    size_t const start = block * 4;
+    size_t const count = std::min(random_lanes * 4, end - start);
+    for (size_t i{0}; i < count; i++)
+    {
+      data[start + i] = values[i % 4][i / 4];
+    }
+  }
+}
+
+// Fills `data` with `size` values drawn from `dist`, on the calling thread. Devices split large
+// buffers across their own threads with fill_random_blocks, which gives the same values.
+inline void
+fill_random(float *data, size_t const size, Distribution const dist, uint64_t const seed)
+{
+  fill_random_blocks(data, size, 0, (size + 3) / 4, dist, Philox{seed});
+}
+
+} // namespace backend
+
+} // namespace gpu_playground
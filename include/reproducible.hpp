@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "buffer.hpp"
+#include "host_storage.hpp"
+
+namespace gpu_playground::backend
+{
+
+struct ReductionConfig
+{
+  // Reduce on the CPU backends with the fixed-shape trees below, whose result depends on the
+  // data and its shape alone: not on the backend, the instruction set or the number of threads.
+  // Slower than the default kernels, which follow the width of the hardware.
+  bool reproducible{false};
+};
+
+// Meant to be set once at startup.
+inline ReductionConfig &reduction_config()
+{
+  static ReductionConfig config;
+  return config;
+}
+
+[[nodiscard]] inline bool reproducible_reductions() { return reduction_config().reproducible; }
+
+namespace reproducible
+{
+
+// A vector is cut into leaves of `leaf` values. Every leaf is reduced in `lanes` interleaved
+// accumulators, value i going to lane i % lanes, and the lanes are folded pairwise. The leaves
+// are then folded pairwise, always splitting a range of them at its midpoint. The lanes are
+// independent, so that the compiler may vectorise them at any width without changing the result.
+inline constexpr size_t lanes{16};
+inline constexpr size_t leaf{4096};
+
+// Along the columns, blocks of `block_rows` rows are accumulated row after row, then the blocks
+// are folded pairwise.
+inline constexpr size_t block_rows{256};
+
+static_assert(leaf % lanes == 0);
+
+// Products and squares are fused explicitly: std::fma rounds once everywhere, whereas leaving
+// `a * b + c` to the compiler fuses it or not depending on the target.
+struct Sum
+{
+  [[nodiscard]] static constexpr float init() { return 0.0F; }
+
+  [[nodiscard]] static float apply(float const acc, float const x) { return acc + x; }
+
+  [[nodiscard]] static float combine(float const a, float const b) { return a + b; }
+
+  [[nodiscard]] static float finalize(float const acc) { return acc; }
+};
+
+struct Max
+{
+  [[nodiscard]] static constexpr float init() { return -std::numeric_limits<float>::infinity(); }
+
+  [[nodiscard]] static float apply(float const acc, float const x) { return std::max(acc, x); }
+
+  [[nodiscard]] static float combine(float const a, float const b) { return std::max(a, b); }
+
+  [[nodiscard]] static float finalize(float const acc) { return acc; }
+};
+
+struct Min
+{
+  [[nodiscard]] static constexpr float init() { return std::numeric_limits<float>::infinity(); }
+
+  [[nodiscard]] static float apply(float const acc, float const x) { return std::min(acc, x); }
+
+  [[nodiscard]] static float combine(float const a, float const b) { return std::min(a, b); }
+
+  [[nodiscard]] static float finalize(float const acc) { return acc; }
+};
+
+struct Norm2
+{
+  [[nodiscard]] static constexpr float init() { return 0.0F; }
+
+  [[nodiscard]] static float apply(float const acc, float const x) { return std::fma(x, x, acc); }
+
+  [[nodiscard]] static float combine(float const a, float const b) { return a + b; }
+
+  [[nodiscard]] static float finalize(float const acc) { return std::sqrt(acc); }
+};
+
+// Folds rows [begin, end) of `partials`, `width` values each, into row `begin`.
+template <class Op>
+void fold(float *partials, size_t const width, size_t const begin, size_t const end)
+{
+  if (end - begin < 2)
+  {
+    return;
+  }
+
+  size_t const mid = begin + ((end - begin) / 2);
+  fold<Op>(partials, width, begin, mid);
+  fold<Op>(partials, width, mid, end);
+
+  float *lhs       = &partials[begin * width];
+  float const *rhs = &partials[mid * width];
+  for (size_t j{0}; j < width; j++)
+  {
+    lhs[j] = Op::combine(lhs[j], rhs[j]);
+  }
+}
+
+// Reduces one leaf, `load(i)` giving the value added to the accumulators for index i.
+template <class Op, class Load>
+float reduce_leaf(size_t const size, Load const &load)
+{
+  std::array<float, lanes> acc{};
+  acc.fill(Op::init());
+
+  size_t const full = size - (size % lanes);
+  for (size_t i{0}; i < full; i += lanes)
+  {
+    for (size_t l{0}; l < lanes; l++)
+    {
+      acc[l] = load(acc[l], i + l);
+    }
+  }
+  for (size_t i{full}; i < size; i++)
+  {
+    acc[i - full] = load(acc[i - full], i);
+  }
+
+  fold<Op>(acc.data(), 1, 0, lanes);
+  return acc.front();
+}
+
+[[nodiscard]] constexpr size_t leaf_count(size_t const size)
+{
+  return std::max<size_t>(1, (size + leaf - 1) / leaf);
+}
+
+template <class Op>
+float reduce_leaf(float const *data, size_t const size)
+{
+  return reduce_leaf<Op>(
+      size, [data](float const acc, size_t const i) { return Op::apply(acc, data[i]); }
+  );
+}
+
+inline float dot_leaf(float const *a, float const *b, size_t const size)
+{
+  return reduce_leaf<Sum>(
+      size, [a, b](float const acc, size_t const i) { return std::fma(a[i], b[i], acc); }
+  );
+}
+
+// Runs `fn(begin, end)` over [0, size), in any split: every index is computed on its own.
+struct Sequential
+{
+  template <class F>
+  void operator()(size_t const size, size_t, F const &fn) const
+  {
+    fn(size_t{0}, size);
+  }
+};
+
+// Reduces `size` values whose leaves are reduced by `leaf_fn(begin, length)`, running the leaves
+// through `for_each`, which may split them across threads.
+template <class Op, class LeafFn, class ForEach>
+float reduce_leaves(size_t const size, LeafFn const &leaf_fn, ForEach const &for_each)
+{
+  size_t const count = leaf_count(size);
+  if (count == 1)
+  {
+    return leaf_fn(0, size);
+  }
+
+  std::vector<float> partials(count);
+  for_each(
+      count,
+      4,
+      [&](size_t const begin, size_t const end)
+      {
+        for (size_t l{begin}; l < end; l++)
+        {
+          size_t const start = l * leaf;
+          partials[l]        = leaf_fn(start, std::min(leaf, size - start));
+        }
+      }
+  );
+  fold<Op>(partials.data(), 1, 0, count);
+  return partials.front();
+}
+
+// Reduces `a` into `c` along `axis`. `for_each(size, grain, fn)` runs `fn(begin, end)` over
+// ranges covering [0, size), a multiple of `grain` long, possibly in parallel.
+template <class Op, class ForEach = Sequential>
+void reduce(Buffer const &a, Buffer &c, Axis const axis, ForEach const &for_each = {})
+{
+  assert_compatible_reduce(a, c, axis);
+
+  auto const *data        = host_ptr(a);
+  auto *out               = host_ptr(c);
+  auto const [rows, cols] = a.shape();
+
+  switch (axis)
+  {
+  case Axis::ROWS:
+    for_each(
+        rows,
+        std::max<size_t>(1, leaf / cols),
+        [&](size_t const begin, size_t const end)
+        {
+          for (size_t i{begin}; i < end; i++)
+          {
+            float const *row   = &data[i * cols];
+            auto const leaf_fn = [row](size_t const start, size_t const length)
+            { return reduce_leaf<Op>(&row[start], length); };
+            out[i] = Op::finalize(reduce_leaves<Op>(cols, leaf_fn, Sequential{}));
+          }
+        }
+    );
+    break;
+  case Axis::COLS:
+  {
+    size_t const blocks = (rows + block_rows - 1) / block_rows;
+    std::vector<float> partials(blocks * cols);
+    for_each(
+        blocks,
+        std::max<size_t>(1, leaf / (block_rows * cols)),
+        [&](size_t const begin, size_t const end)
+        {
+          for (size_t blk{begin}; blk < end; blk++)
+          {
+            float *acc = &partials[blk * cols];
+            std::fill_n(acc, cols, Op::init());
+            for (size_t i{blk * block_rows}; i < std::min(rows, (blk + 1) * block_rows); i++)
+            {
+              for (size_t j{0}; j < cols; j++)
+              {
+                acc[j] = Op::apply(acc[j], data[(i * cols) + j]);
+              }
+            }
+          }
+        }
+    );
+    fold<Op>(partials.data(), cols, 0, blocks);
+    for (size_t j{0}; j < cols; j++)
+    {
+      out[j] = Op::finalize(partials[j]);
+    }
+    break;
+  }
+  case Axis::ALL:
+  {
+    auto const leaf_fn = [data](size_t const start, size_t const length)
+    { return reduce_leaf<Op>(&data[start], length); };
+    out[0] = Op::finalize(reduce_leaves<Op>(a.size(), leaf_fn, for_each));
+    break;
+  }
+  }
+}
+
+template <class ForEach = Sequential>
+void dot(Buffer const &a, Buffer const &b, Buffer &c, ForEach const &for_each = {})
+{
+  assert_compatible_dot(a, b, c);
+
+  auto const *data_a = host_ptr(a);
+  auto const *data_b = host_ptr(b);
+  auto const leaf_fn = [data_a, data_b](size_t const start, size_t const length)
+  { return dot_leaf(&data_a[start], &data_b[start], length); };
+  host_ptr(c)[0] = reduce_leaves<Sum>(a.size(), leaf_fn, for_each);
+}
+
+} // namespace reproducible
+
+} // namespace gpu_playground::backend
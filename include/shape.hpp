@@ -1,9 +1,33 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 struct Shape
 {
   size_t rows{0};
   size_t cols{0};
 };
+
+// ROWS reduces every row to one value (rows x 1), COLS reduces every column to one value
+// (1 x cols) and ALL reduces the whole buffer to a single value (1 x 1).
+enum class Axis : uint8_t
+{
+  ROWS,
+  COLS,
+  ALL
+};
+
+constexpr Shape reduced_shape(Shape const shape, Axis const axis)
+{
+  switch (axis)
+  {
+  case Axis::ROWS:
+    return {shape.rows, 1};
+  case Axis::COLS:
+    return {1, shape.cols};
+  case Axis::ALL:
+  default:
+    return {1, 1};
+  }
+}
@@ -1,20 +1,133 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <iostream>
-#include <iterator>
-#include <random>
+#include <stdexcept>
 
 #include "device.hpp"
+#include "graph.hpp"
+#include "host_storage.hpp"
+#include "host_view.hpp"
+#include "random.hpp"
 
 namespace gpu_playground
 {
 
+template <class Backend>
+class BasicTensor;
+
 class Tensor
 {
 private:
+  template <class Backend>
+  friend class BasicTensor;
+
   DevicePtr device;
+  // `shared` owns the memory and counts the tensors using it, `buffer` is a handle to it that
+  // ops read and write through. Copies share the memory until one of them is written to, and
+  // making one only bumps the count, so threads may copy a tensor they share at the same time.
   backend::Buffer buffer;
+  backend::SharedBuffer shared;
+  // Set once a capturing graph writes to the tensor: its replays write to the buffer again, so
+  // the buffer is never shared with copies.
+  bool graph_output{false};
+
+  Tensor(backend::Buffer buffer, DevicePtr device)
+      : Tensor(backend::SharedBuffer(std::move(buffer)), std::move(device))
+  {
+  }
+
+  // A tensor using the memory owned by `shared`.
+  Tensor(backend::SharedBuffer shared, DevicePtr device)
+      : device(std::move(device)), buffer(Tensor::alias(shared.get())), shared(std::move(shared))
+  {
+  }
+
+  // A handle to the memory of `owner` that does not free it.
+  static backend::Buffer alias(backend::Buffer &owner)
+  {
+    return {
+        backend::HandlePtr{owner.get(), [](void *) {}}, owner.shape(), owner.device_type()
+    };
+  }
+
+  // Makes the tensor the only owner of `buffer`.
+  void reset(backend::Buffer buffer)
+  {
+    this->shared = backend::SharedBuffer(std::move(buffer));
+    this->buffer = Tensor::alias(this->shared.get());
+  }
+
+  static Tensor clone(Tensor const &other)
+  {
+    // While a graph is capturing the copy is made eagerly, so the graph can record it.
+    if (Graph::capturing() != nullptr or other.graph_output)
+    {
+      return Tensor::deep_copy(other);
+    }
+
+    return {other.shared, other.device};
+  }
+
+  // Must precede every write to the buffer: a buffer still shared with other tensors is replaced
+  // by a private copy. This happens once per shared tensor and is not recorded by a capturing
+  // graph, which keeps reading the tensor through its buffer.
+  void own()
+  {
+    if (Graph::capturing() != nullptr)
+    {
+      this->graph_output = true;
+    }
+
+    if (this->shared.is_shared())
+    {
+      auto buffer = this->device->new_pooled_buffer(this->buffer.shape());
+      this->device->copy_buffer(this->buffer, buffer);
+      this->reset(std::move(buffer));
+    }
+  }
+
+  // While a graph is capturing, the buffers of new tensors are handed over to it.
+  static backend::Buffer adopt(backend::Buffer buffer, bool const constant)
+  {
+    auto *graph = Graph::capturing();
+    return graph == nullptr ? std::move(buffer) : graph->adopt(std::move(buffer), constant);
+  }
+
+  static Tensor output(Shape const shape, DevicePtr const &device)
+  {
+    return {Tensor::adopt(device->new_pooled_buffer(shape), false), device};
+  }
+
+  void record(
+      backend::OpKind const kind,
+      std::initializer_list<backend::Buffer const *> inputs,
+      backend::Buffer const &out,
+      Axis const axis = Axis::ALL
+  ) const
+  {
+    auto *graph = Graph::capturing();
+    if (graph != nullptr)
+    {
+      graph->record(this->device, kind, inputs, out, axis);
+    }
+  }
+
+  template <class E>
+  void evaluate(expr::Expr<E> const &expression)
+  {
+    this->own();
+    auto const program = expr::compile(expression);
+    this->device->eval(program, this->buffer);
+
+    auto *graph = Graph::capturing();
+    if (graph != nullptr)
+    {
+      graph->record(this->device, program, this->buffer);
+    }
+  }
 
 public:
   Tensor()  = delete;
@@ -24,39 +137,104 @@ public:
   Tensor &operator=(Tensor &&) = default;
 
   Tensor(std::vector<float> data, Shape shape, DevicePtr device)
-      : device(std::move(device)), buffer(this->device->new_buffer(std::move(data), shape))
+      : Tensor(Tensor::adopt(device->new_buffer(std::move(data), shape), true), device)
+  {
+  }
+
+  // Copies are cheap: the buffer is only duplicated when one of the tensors is written to. A
+  // tensor a graph writes to is copied at once.
+  Tensor(Tensor const &other) : Tensor(Tensor::clone(other)) {}
+
+  // Evaluates a lazy element-wise expression in a single fused pass.
+  template <class E>
+  Tensor(expr::Expr<E> const &expression)
+      : Tensor(Tensor::output(expression.derived().shape(), expression.derived().device()))
   {
+    this->evaluate(expression);
   }
 
-  Tensor(Tensor const &other)
-      : device(other.device), buffer(this->device->new_buffer_with_shape(other.buffer.shape()))
+  // A copy in a buffer of its own, made at once rather than on the first write.
+  static Tensor deep_copy(Tensor const &other)
   {
-    this->device->copy_buffer(other.buffer, this->buffer);
+    auto copy = Tensor::output(other.buffer.shape(), other.device);
+    copy.device->copy_buffer(other.buffer, copy.buffer);
+    copy.record(backend::OpKind::COPY, {&other.buffer}, copy.buffer);
+    return copy;
+  }
+
+  // A tensor with unspecified contents, for workspace that is about to be overwritten.
+  static Tensor empty(Shape shape, DevicePtr const &device)
+  {
+    return Tensor::output(shape, device);
+  }
+
+  // Wraps host memory owned elsewhere without copying it. `deleter` is called on `data` once the
+  // tensor is done with it; leaving it empty borrows memory that must outlive the tensor. Only
+  // CPU devices can use external memory, which must be aligned to `backend::host_alignment`: the
+  // kernels load it in aligned batches. Otherwise std::invalid_argument is thrown, and `data`
+  // stays with the caller.
+  static Tensor from_external(
+      float *data, Shape shape, DevicePtr device, std::function<void(float *)> deleter = {}
+  )
+  {
+    if (not backend::is_host_device(device->type()))
+    {
+      throw std::invalid_argument("External memory is only supported on CPU devices");
+    }
+    if (reinterpret_cast<std::uintptr_t>(data) % backend::host_alignment != 0)
+    {
+      throw std::invalid_argument("External memory is not aligned to backend::host_alignment");
+    }
+
+    backend::HandlePtr handle{
+        data,
+        [deleter = std::move(deleter)](void *ptr) -> void
+        {
+          if (deleter)
+          {
+            deleter(static_cast<float *>(ptr));
+          }
+        }
+    };
+    // An asynchronous device calls the deleter on its stream, once the ops queued on the memory
+    // have run.
+    handle          = device->adopt_host_storage(std::move(handle));
+    auto const type = device->type();
+    return {
+        Tensor::adopt(backend::Buffer(std::move(handle), shape, type), true), std::move(device)
+    };
+  }
+
+  static Tensor full(Shape shape, float const value, DevicePtr device)
+  {
+    auto buffer = device->new_buffer_uninitialized(shape);
+    device->fill(buffer, value);
+    return {Tensor::adopt(std::move(buffer), true), std::move(device)};
   }
 
   static Tensor zeros(Shape shape, DevicePtr device)
   {
-    return {std::vector<float>(shape.rows * shape.cols, 0.0), shape, std::move(device)};
+    return Tensor::full(shape, 0.0F, std::move(device));
   }
 
   static Tensor ones(Shape shape, DevicePtr device)
   {
-    return {std::vector<float>(shape.rows * shape.cols, 1.0), shape, std::move(device)};
+    return Tensor::full(shape, 1.0F, std::move(device));
   }
 
-  static Tensor rand(Shape shape, DevicePtr device)
+  // Values drawn from `dist`, the same for a given seed on every device.
+  static Tensor
+  random(Shape shape, Distribution const dist, DevicePtr device, uint64_t const seed = 0)
   {
-    std::mt19937 rng{std::random_device{}()};
-    constexpr float min{1.0};
-    constexpr float max{1.0};
-    std::uniform_real_distribution<float> dist(min, max);
-
-    size_t const size{shape.rows * shape.cols};
-    std::vector<float> data;
-    data.reserve(size);
-    std::generate_n(std::back_inserter(data), size, [&rng, &dist]() { return dist(rng); });
+    auto buffer = device->new_buffer_uninitialized(shape);
+    device->fill_random(buffer, dist, seed);
+    return {Tensor::adopt(std::move(buffer), true), std::move(device)};
+  }
 
-    return {std::move(data), shape, std::move(device)};
+  // Values uniformly distributed in [0, 1).
+  static Tensor rand(Shape shape, DevicePtr device, uint64_t const seed = 0)
+  {
+    return Tensor::random(shape, Distribution::uniform(), std::move(device), seed);
   }
 
   void to(DevicePtr device)
@@ -66,9 +244,22 @@ public:
       return;
     }
 
-    auto const data  = this->cpu();
     auto const shape = this->buffer.shape();
-    *this            = Tensor(data, shape, std::move(device));
+
+    // CPU backends share the host storage layout, so the buffer only needs to be retagged, once
+    // the ops queued on it by an asynchronous device have completed.
+    if (backend::is_host_device(this->device->type()) and backend::is_host_device(device->type()))
+    {
+      this->own();
+      this->sync();
+      auto handle = device->adopt_host_storage(this->shared.get().take_handle());
+      this->reset(backend::Buffer(std::move(handle), shape, device->type()));
+      this->device = std::move(device);
+      return;
+    }
+
+    auto const data = this->cpu();
+    *this           = Tensor(data, shape, std::move(device));
   }
 
   Tensor &operator=(Tensor const &other)
@@ -78,22 +269,67 @@ public:
       return *this;
     }
 
+    // The copy goes into the existing buffer, which a graph may have recorded to replay into.
+    this->own();
     this->device = other.device;
     this->device->copy_buffer(other.buffer, this->buffer);
+    this->record(backend::OpKind::COPY, {&other.buffer}, this->buffer);
+
+    return *this;
+  }
+
+  template <class E>
+  Tensor &operator=(expr::Expr<E> const &expression)
+  {
+    this->evaluate(expression);
+
+    return *this;
+  }
+
+  // Starts a lazy expression: arithmetic on the result builds expression nodes instead of
+  // tensors, and the whole chain is evaluated in one pass when assigned to a Tensor.
+  [[nodiscard]] expr::Leaf lazy() const & { return {this->buffer, this->device}; }
+
+  expr::Leaf lazy() const && = delete;
+
+  operator expr::Leaf() const & { return this->lazy(); }
+
+  operator expr::Leaf() const && = delete;
+
+  operator expr::Scalar() const & { return expr::Scalar{this->buffer}; }
+
+  operator expr::Scalar() const && = delete;
+
+  // this = alpha * x + this, in a single pass.
+  Tensor &axpy(Tensor const &alpha, Tensor const &x)
+  {
+    this->own();
+    this->device->axpy(alpha.buffer, x.buffer, this->buffer);
+    this->record(backend::OpKind::AXPY, {&alpha.buffer, &x.buffer}, this->buffer);
+
+    return *this;
+  }
+
+  // this = alpha * x + beta * this, in a single pass.
+  Tensor &axpby(Tensor const &alpha, Tensor const &x, Tensor const &beta)
+  {
+    this->own();
+    this->device->axpby(alpha.buffer, x.buffer, beta.buffer, this->buffer);
+    this->record(backend::OpKind::AXPBY, {&alpha.buffer, &x.buffer, &beta.buffer}, this->buffer);
 
     return *this;
   }
 
   Tensor &operator+=(Tensor const &rhs)
   {
-    this->device->add(this->buffer, rhs.buffer, this->buffer);
+    Tensor::add_into(*this, rhs, *this);
 
     return *this;
   }
 
   Tensor &operator-=(Tensor const &rhs)
   {
-    this->device->sub(this->buffer, rhs.buffer, this->buffer);
+    Tensor::sub_into(*this, rhs, *this);
 
     return *this;
   }
@@ -102,61 +338,303 @@ public:
 
   friend Tensor operator-(Tensor lhs, Tensor const &rhs);
 
+  // The *_into variants write into a caller-provided `out` of the right shape, so hot loops can
+  // allocate their workspace once and reuse it on every iteration.
+  static void add_into(Tensor const &a, Tensor const &b, Tensor &out)
+  {
+    out.own();
+    a.device->add(a.buffer, b.buffer, out.buffer);
+    a.record(backend::OpKind::ADD, {&a.buffer, &b.buffer}, out.buffer);
+  }
+
+  static void sub_into(Tensor const &a, Tensor const &b, Tensor &out)
+  {
+    out.own();
+    a.device->sub(a.buffer, b.buffer, out.buffer);
+    a.record(backend::OpKind::SUB, {&a.buffer, &b.buffer}, out.buffer);
+  }
+
+  static void mul_into(Tensor const &a, Tensor const &b, Tensor &out)
+  {
+    assert(&out != &a and &out != &b and "Output must not alias an input");
+    out.own();
+    a.device->mul(a.buffer, b.buffer, out.buffer);
+    a.record(backend::OpKind::MUL, {&a.buffer, &b.buffer}, out.buffer);
+  }
+
+  static void cmul_into(Tensor const &a, Tensor const &b, Tensor &out)
+  {
+    out.own();
+    a.device->cmul(a.buffer, b.buffer, out.buffer);
+    a.record(backend::OpKind::CMUL, {&a.buffer, &b.buffer}, out.buffer);
+  }
+
+  static void cdiv_into(Tensor const &a, Tensor const &b, Tensor &out)
+  {
+    out.own();
+    a.device->cdiv(a.buffer, b.buffer, out.buffer);
+    a.record(backend::OpKind::CDIV, {&a.buffer, &b.buffer}, out.buffer);
+  }
+
+  static void sadd_into(Tensor const &a, Tensor const &b, Tensor &out)
+  {
+    out.own();
+    a.device->sadd(a.buffer, b.buffer, out.buffer);
+    a.record(backend::OpKind::SADD, {&a.buffer, &b.buffer}, out.buffer);
+  }
+
+  static void ssub_into(Tensor const &a, Tensor const &b, Tensor &out)
+  {
+    out.own();
+    a.device->ssub(a.buffer, b.buffer, out.buffer);
+    a.record(backend::OpKind::SSUB, {&a.buffer, &b.buffer}, out.buffer);
+  }
+
+  static void smul_into(Tensor const &a, Tensor const &b, Tensor &out)
+  {
+    out.own();
+    a.device->smul(a.buffer, b.buffer, out.buffer);
+    a.record(backend::OpKind::SMUL, {&a.buffer, &b.buffer}, out.buffer);
+  }
+
+  static void sdiv_into(Tensor const &a, Tensor const &b, Tensor &out)
+  {
+    out.own();
+    a.device->sdiv(a.buffer, b.buffer, out.buffer);
+    a.record(backend::OpKind::SDIV, {&a.buffer, &b.buffer}, out.buffer);
+  }
+
+  static void transpose_into(Tensor const &a, Tensor &out)
+  {
+    assert(&out != &a and "Output must not alias the input");
+    out.own();
+    a.device->transpose(a.buffer, out.buffer);
+    a.record(backend::OpKind::TRANSPOSE, {&a.buffer}, out.buffer);
+  }
+
+  static void dot_into(Tensor const &a, Tensor const &b, Tensor &out)
+  {
+    out.own();
+    a.device->dot(a.buffer, b.buffer, out.buffer);
+    a.record(backend::OpKind::DOT, {&a.buffer, &b.buffer}, out.buffer);
+  }
+
+  static void sum_into(Tensor const &a, Tensor &out, Axis const axis = Axis::ALL)
+  {
+    out.own();
+    a.device->sum(a.buffer, out.buffer, axis);
+    a.record(backend::OpKind::SUM, {&a.buffer}, out.buffer, axis);
+  }
+
+  static void max_into(Tensor const &a, Tensor &out, Axis const axis = Axis::ALL)
+  {
+    out.own();
+    a.device->max(a.buffer, out.buffer, axis);
+    a.record(backend::OpKind::MAX, {&a.buffer}, out.buffer, axis);
+  }
+
+  static void min_into(Tensor const &a, Tensor &out, Axis const axis = Axis::ALL)
+  {
+    out.own();
+    a.device->min(a.buffer, out.buffer, axis);
+    a.record(backend::OpKind::MIN, {&a.buffer}, out.buffer, axis);
+  }
+
+  static void mean_into(Tensor const &a, Tensor &out, Axis const axis = Axis::ALL)
+  {
+    Tensor::sum_into(a, out, axis);
+
+    // Divides by a count the device caches, so repeated means allocate nothing.
+    auto const &count = a.device->count_buffer(a.buffer.size() / out.buffer.size());
+    a.device->sdiv(out.buffer, count, out.buffer);
+    a.record(backend::OpKind::SDIV, {&out.buffer, &count}, out.buffer);
+  }
+
+  static void norm2_into(Tensor const &a, Tensor &out, Axis const axis = Axis::ALL)
+  {
+    out.own();
+    a.device->norm2(a.buffer, out.buffer, axis);
+    a.record(backend::OpKind::NORM2, {&a.buffer}, out.buffer, axis);
+  }
+
+  // In-place variants: `this` is both the first operand and the output.
+  Tensor &cmul_(Tensor const &other)
+  {
+    Tensor::cmul_into(*this, other, *this);
+
+    return *this;
+  }
+
+  Tensor &cdiv_(Tensor const &other)
+  {
+    Tensor::cdiv_into(*this, other, *this);
+
+    return *this;
+  }
+
+  Tensor &sadd_(Tensor const &other)
+  {
+    Tensor::sadd_into(*this, other, *this);
+
+    return *this;
+  }
+
+  Tensor &ssub_(Tensor const &other)
+  {
+    Tensor::ssub_into(*this, other, *this);
+
+    return *this;
+  }
+
+  Tensor &smul_(Tensor const &other)
+  {
+    Tensor::smul_into(*this, other, *this);
+
+    return *this;
+  }
+
+  Tensor &sdiv_(Tensor const &other)
+  {
+    Tensor::sdiv_into(*this, other, *this);
+
+    return *this;
+  }
+
   Tensor operator*(Tensor const &other) const
   {
     Tensor out =
-        Tensor::zeros(Shape{this->buffer.shape().rows, other.buffer.shape().cols}, this->device);
-    this->device->mul(this->buffer, other.buffer, out.buffer);
+        Tensor::output(Shape{this->buffer.shape().rows, other.buffer.shape().cols}, this->device);
+    Tensor::mul_into(*this, other, out);
     return out;
   }
 
-  [[nodiscard]] Tensor cmul(Tensor const &other) const
+  // The && overloads are picked when `this` is a temporary: its buffer is reused for the result
+  // instead of allocating a new one.
+  [[nodiscard]] Tensor cmul(Tensor const &other) const &
   {
-    Tensor out = Tensor::zeros(this->buffer.shape(), this->device);
-    this->device->cmul(this->buffer, other.buffer, out.buffer);
+    Tensor out = Tensor::output(this->buffer.shape(), this->device);
+    Tensor::cmul_into(*this, other, out);
     return out;
   }
 
-  [[nodiscard]] Tensor cdiv(Tensor const &other) const
+  [[nodiscard]] Tensor cmul(Tensor const &other) &&
   {
-    Tensor out = Tensor::zeros(this->buffer.shape(), this->device);
-    this->device->cdiv(this->buffer, other.buffer, out.buffer);
+    this->cmul_(other);
+    return std::move(*this);
+  }
+
+  [[nodiscard]] Tensor cdiv(Tensor const &other) const &
+  {
+    Tensor out = Tensor::output(this->buffer.shape(), this->device);
+    Tensor::cdiv_into(*this, other, out);
     return out;
   }
 
-  [[nodiscard]] Tensor sadd(Tensor const &other) const
+  [[nodiscard]] Tensor cdiv(Tensor const &other) &&
   {
-    Tensor out = Tensor::zeros(this->buffer.shape(), this->device);
-    this->device->sadd(this->buffer, other.buffer, out.buffer);
+    this->cdiv_(other);
+    return std::move(*this);
+  }
+
+  [[nodiscard]] Tensor sadd(Tensor const &other) const &
+  {
+    Tensor out = Tensor::output(this->buffer.shape(), this->device);
+    Tensor::sadd_into(*this, other, out);
     return out;
   }
 
-  [[nodiscard]] Tensor ssub(Tensor const &other) const
+  [[nodiscard]] Tensor sadd(Tensor const &other) &&
   {
-    Tensor out = Tensor::zeros(this->buffer.shape(), this->device);
-    this->device->ssub(this->buffer, other.buffer, out.buffer);
+    this->sadd_(other);
+    return std::move(*this);
+  }
+
+  [[nodiscard]] Tensor ssub(Tensor const &other) const &
+  {
+    Tensor out = Tensor::output(this->buffer.shape(), this->device);
+    Tensor::ssub_into(*this, other, out);
     return out;
   }
 
-  [[nodiscard]] Tensor smul(Tensor const &other) const
+  [[nodiscard]] Tensor ssub(Tensor const &other) &&
+  {
+    this->ssub_(other);
+    return std::move(*this);
+  }
+
+  [[nodiscard]] Tensor smul(Tensor const &other) const &
   {
-    Tensor out = Tensor::zeros(this->buffer.shape(), this->device);
-    this->device->smul(this->buffer, other.buffer, out.buffer);
+    Tensor out = Tensor::output(this->buffer.shape(), this->device);
+    Tensor::smul_into(*this, other, out);
     return out;
   }
 
-  [[nodiscard]] Tensor sdiv(Tensor const &other) const
+  [[nodiscard]] Tensor smul(Tensor const &other) &&
+  {
+    this->smul_(other);
+    return std::move(*this);
+  }
+
+  [[nodiscard]] Tensor sdiv(Tensor const &other) const &
   {
-    Tensor out = Tensor::zeros(this->buffer.shape(), this->device);
-    this->device->sdiv(this->buffer, other.buffer, out.buffer);
+    Tensor out = Tensor::output(this->buffer.shape(), this->device);
+    Tensor::sdiv_into(*this, other, out);
     return out;
   }
 
+  [[nodiscard]] Tensor sdiv(Tensor const &other) &&
+  {
+    this->sdiv_(other);
+    return std::move(*this);
+  }
+
   [[nodiscard]] Tensor transpose() const
   {
     auto const [rows, cols] = this->buffer.shape();
-    Tensor out              = Tensor::zeros(Shape{cols, rows}, this->device);
-    this->device->transpose(this->buffer, out.buffer);
+    Tensor out              = Tensor::output(Shape{cols, rows}, this->device);
+    Tensor::transpose_into(*this, out);
+    return out;
+  }
+
+  [[nodiscard]] Tensor dot(Tensor const &other) const
+  {
+    Tensor out = Tensor::output(Shape{1, 1}, this->device);
+    Tensor::dot_into(*this, other, out);
+    return out;
+  }
+
+  [[nodiscard]] Tensor sum(Axis const axis = Axis::ALL) const
+  {
+    Tensor out = Tensor::output(reduced_shape(this->buffer.shape(), axis), this->device);
+    Tensor::sum_into(*this, out, axis);
+    return out;
+  }
+
+  [[nodiscard]] Tensor max(Axis const axis = Axis::ALL) const
+  {
+    Tensor out = Tensor::output(reduced_shape(this->buffer.shape(), axis), this->device);
+    Tensor::max_into(*this, out, axis);
+    return out;
+  }
+
+  [[nodiscard]] Tensor min(Axis const axis = Axis::ALL) const
+  {
+    Tensor out = Tensor::output(reduced_shape(this->buffer.shape(), axis), this->device);
+    Tensor::min_into(*this, out, axis);
+    return out;
+  }
+
+  [[nodiscard]] Tensor mean(Axis const axis = Axis::ALL) const
+  {
+    Tensor out = Tensor::output(reduced_shape(this->buffer.shape(), axis), this->device);
+    Tensor::mean_into(*this, out, axis);
+    return out;
+  }
+
+  [[nodiscard]] Tensor norm2(Axis const axis = Axis::ALL) const
+  {
+    Tensor out = Tensor::output(reduced_shape(this->buffer.shape(), axis), this->device);
+    Tensor::norm2_into(*this, out, axis);
     return out;
   }
 
@@ -166,7 +644,24 @@ public:
 
   void sync() const { this->device->sync(this->buffer); }
 
+  // Read-only access to the data in host memory, without the copy made by cpu().
+  [[nodiscard]] HostView host_view() const &
+  {
+    return {this->device->host_data(this->buffer), this->buffer.shape()};
+  }
+
+  HostView host_view() const && = delete;
+
+  // The value of a 1x1 tensor.
+  [[nodiscard]] float item() const
+  {
+    assert(this->buffer.size() == 1 and "Tensor must have a single element");
+    return *this->device->host_data(this->buffer);
+  }
+
   [[nodiscard]] Shape shape() const { return this->buffer.shape(); }
+
+  [[nodiscard]] DevicePtr const &get_device() const { return this->device; }
 };
 
 inline Tensor operator+(Tensor lhs, Tensor const &rhs)
@@ -181,6 +676,61 @@ inline Tensor operator-(Tensor lhs, Tensor const &rhs)
   return lhs;
 }
 
+// A temporary right-hand side is reused for the result, a temporary left-hand side already is
+// through the by-value overloads above.
+inline Tensor operator+(Tensor const &lhs, Tensor &&rhs)
+{
+  Tensor::add_into(lhs, rhs, rhs);
+  return std::move(rhs);
+}
+
+inline Tensor operator-(Tensor const &lhs, Tensor &&rhs)
+{
+  Tensor::sub_into(lhs, rhs, rhs);
+  return std::move(rhs);
+}
+
+template <class R>
+expr::Binary<backend::ExprOp::ADD, expr::Leaf, R>
+operator+(Tensor const &lhs, expr::Expr<R> const &rhs)
+{
+  return lhs.lazy() + rhs;
+}
+
+template <class L>
+expr::Binary<backend::ExprOp::ADD, L, expr::Leaf>
+operator+(expr::Expr<L> const &lhs, Tensor const &rhs)
+{
+  return lhs + rhs.lazy();
+}
+
+template <class R>
+expr::Binary<backend::ExprOp::SUB, expr::Leaf, R>
+operator-(Tensor const &lhs, expr::Expr<R> const &rhs)
+{
+  return lhs.lazy() - rhs;
+}
+
+template <class L>
+expr::Binary<backend::ExprOp::SUB, L, expr::Leaf>
+operator-(expr::Expr<L> const &lhs, Tensor const &rhs)
+{
+  return lhs - rhs.lazy();
+}
+
+// Expressions keep pointers to their operands, a temporary would be gone before evaluation.
+template <class R>
+void operator+(Tensor &&lhs, expr::Expr<R> const &rhs) = delete;
+
+template <class L>
+void operator+(expr::Expr<L> const &lhs, Tensor &&rhs) = delete;
+
+template <class R>
+void operator-(Tensor &&lhs, expr::Expr<R> const &rhs) = delete;
+
+template <class L>
+void operator-(expr::Expr<L> const &lhs, Tensor &&rhs) = delete;
+
 inline std::ostream &operator<<(std::ostream &os, Tensor const &t)
 {
   auto const data         = t.cpu();
@@ -0,0 +1,281 @@
+#include <array>
+#include <cassert>
+#include <tuple>
+#include <utility>
+
+#include "async_device.hpp"
+#include "host_storage.hpp"
+
+namespace gpu_playground::backend
+{
+
+namespace
+{
+
+// The memory and layout of a buffer. Jobs capture views rather than the Buffer objects of the
+// caller, which may be gone by the time they run, while the memory is only freed on the stream.
+class View
+{
+private:
+  void *data;
+  Shape shape;
+  DeviceType type;
+
+public:
+  explicit View(Buffer const &buffer)
+      : data(const_cast<void *>(buffer.get())), shape(buffer.shape()), type(buffer.device_type())
+  {
+  }
+
+  [[nodiscard]] Buffer buffer() const
+  {
+    return {HandlePtr{this->data, [](void *) {}}, this->shape, this->type};
+  }
+};
+
+} // namespace
+
+template <class Op, class... Buffers>
+void AsyncDevice::enqueue(Op const &op, Buffers const &...buffers) const
+{
+  auto job = [inner = this->inner.get(),
+              op,
+              views = std::array<View, sizeof...(Buffers)>{View{buffers}...}]() -> void
+  {
+    std::apply(
+        [&](auto const &...view)
+        {
+          auto args = std::make_tuple(view.buffer()...);
+          std::apply([&](auto &...arg) { op(*inner, arg...); }, args);
+        },
+        views
+    );
+  };
+  this->stream->submit(std::move(job), {buffers.get()...});
+}
+
+AsyncDevice::AsyncDevice(DevicePtr device)
+    : inner(std::move(device)), stream(std::make_shared<Stream>())
+{
+  assert(is_host_device(this->inner->type()) and "Only CPU devices can run on a stream");
+}
+
+AsyncDevice::~AsyncDevice() { this->stream->finish(); }
+
+HandlePtr AsyncDevice::defer_free(HandlePtr handle) const
+{
+  auto free  = handle.get_deleter();
+  void *data = handle.release();
+  return {
+      data,
+      [stream = this->stream, free = std::move(free)](void *ptr) -> void
+      { stream->retire(ptr, free); }
+  };
+}
+
+void AsyncDevice::add(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->enqueue(
+      [](Device const &device, auto &a, auto &b, auto &c) { device.add(a, b, c); }, a, b, c
+  );
+}
+
+void AsyncDevice::sub(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->enqueue(
+      [](Device const &device, auto &a, auto &b, auto &c) { device.sub(a, b, c); }, a, b, c
+  );
+}
+
+void AsyncDevice::mul(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->enqueue(
+      [](Device const &device, auto &a, auto &b, auto &c) { device.mul(a, b, c); }, a, b, c
+  );
+}
+
+void AsyncDevice::cmul(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->enqueue(
+      [](Device const &device, auto &a, auto &b, auto &c) { device.cmul(a, b, c); }, a, b, c
+  );
+}
+
+void AsyncDevice::cdiv(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->enqueue(
+      [](Device const &device, auto &a, auto &b, auto &c) { device.cdiv(a, b, c); }, a, b, c
+  );
+}
+
+void AsyncDevice::sadd(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->enqueue(
+      [](Device const &device, auto &a, auto &b, auto &c) { device.sadd(a, b, c); }, a, b, c
+  );
+}
+
+void AsyncDevice::ssub(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->enqueue(
+      [](Device const &device, auto &a, auto &b, auto &c) { device.ssub(a, b, c); }, a, b, c
+  );
+}
+
+void AsyncDevice::smul(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->enqueue(
+      [](Device const &device, auto &a, auto &b, auto &c) { device.smul(a, b, c); }, a, b, c
+  );
+}
+
+void AsyncDevice::sdiv(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->enqueue(
+      [](Device const &device, auto &a, auto &b, auto &c) { device.sdiv(a, b, c); }, a, b, c
+  );
+}
+
+void AsyncDevice::axpy(Buffer const &alpha, Buffer const &x, Buffer &y) const
+{
+  this->enqueue(
+      [](Device const &device, auto &alpha, auto &x, auto &y) { device.axpy(alpha, x, y); },
+      alpha,
+      x,
+      y
+  );
+}
+
+void AsyncDevice::axpby(Buffer const &alpha, Buffer const &x, Buffer const &beta, Buffer &y) const
+{
+  this->enqueue(
+      [](Device const &device, auto &alpha, auto &x, auto &beta, auto &y)
+      { device.axpby(alpha, x, beta, y); },
+      alpha,
+      x,
+      beta,
+      y
+  );
+}
+
+void AsyncDevice::dot(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->enqueue(
+      [](Device const &device, auto &a, auto &b, auto &c) { device.dot(a, b, c); }, a, b, c
+  );
+}
+
+void AsyncDevice::sum(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->enqueue([axis](Device const &device, auto &a, auto &c) { device.sum(a, c, axis); }, a, c);
+}
+
+void AsyncDevice::max(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->enqueue([axis](Device const &device, auto &a, auto &c) { device.max(a, c, axis); }, a, c);
+}
+
+void AsyncDevice::min(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->enqueue([axis](Device const &device, auto &a, auto &c) { device.min(a, c, axis); }, a, c);
+}
+
+void AsyncDevice::norm2(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->enqueue([axis](Device const &device, auto &a, auto &c) { device.norm2(a, c, axis); }, a, c);
+}
+
+void AsyncDevice::eval(ExprProgram const &program, Buffer &out) const
+{
+  std::vector<View> operands;
+  std::vector<void const *> buffers{out.get()};
+  operands.reserve(program.operands.size());
+  for (auto const *operand : program.operands)
+  {
+    operands.emplace_back(*operand);
+    buffers.push_back(operand->get());
+  }
+
+  auto job = [inner = this->inner.get(), program, operands, out = View{out}]() -> void
+  {
+    std::vector<Buffer> operand_buffers;
+    operand_buffers.reserve(operands.size());
+    ExprProgram local{program.code, {}, program.depth};
+    for (auto const &operand : operands)
+    {
+      operand_buffers.push_back(operand.buffer());
+      local.operands.push_back(&operand_buffers.back());
+    }
+
+    auto out_buffer = out.buffer();
+    inner->eval(local, out_buffer);
+  };
+  this->stream->submit(std::move(job), buffers);
+}
+
+Buffer AsyncDevice::new_buffer(std::vector<float> data, Shape shape) const
+{
+  auto buffer = this->inner->new_buffer(std::move(data), shape);
+  return {this->defer_free(buffer.take_handle()), shape, buffer.device_type()};
+}
+
+Buffer AsyncDevice::new_buffer_uninitialized(Shape shape) const
+{
+  auto buffer = this->inner->new_buffer_uninitialized(shape);
+  return {this->defer_free(buffer.take_handle()), shape, buffer.device_type()};
+}
+
+HandlePtr AsyncDevice::adopt_host_storage(HandlePtr handle) const
+{
+  return this->defer_free(std::move(handle));
+}
+
+void AsyncDevice::fill(Buffer &buffer, float const value) const
+{
+  this->enqueue(
+      [value](Device const &device, auto &buffer) { device.fill(buffer, value); }, buffer
+  );
+}
+
+void AsyncDevice::fill_random(Buffer &buffer, Distribution const dist, uint64_t const seed) const
+{
+  this->enqueue(
+      [dist, seed](Device const &device, auto &buffer) { device.fill_random(buffer, dist, seed); },
+      buffer
+  );
+}
+
+void AsyncDevice::copy_buffer(Buffer const &from, Buffer &to) const
+{
+  this->enqueue(
+      [](Device const &device, auto &from, auto &to) { device.copy_buffer(from, to); }, from, to
+  );
+}
+
+void AsyncDevice::transpose(Buffer const &from, Buffer &to) const
+{
+  this->enqueue(
+      [](Device const &device, auto &from, auto &to) { device.transpose(from, to); }, from, to
+  );
+}
+
+std::vector<float> AsyncDevice::cpu(Buffer const &buffer) const
+{
+  this->stream->wait(buffer.get());
+  return this->inner->cpu(buffer);
+}
+
+float const *AsyncDevice::host_data(Buffer const &buffer) const
+{
+  this->stream->wait(buffer.get());
+  return this->inner->host_data(buffer);
+}
+
+void AsyncDevice::sync(Buffer const &buffer) const { this->stream->wait(buffer.get()); }
+
+} // namespace gpu_playground::backend
+
+gpu_playground::DevicePtr gpu_playground::make_async_device(DevicePtr device)
+{
+  return std::make_shared<gpu_playground::backend::AsyncDevice>(std::move(device));
+}
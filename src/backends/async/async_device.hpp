@@ -0,0 +1,97 @@
+#pragma once
+
+#include <memory>
+
+#include "device.hpp"
+#include "stream.hpp"
+
+namespace gpu_playground::backend
+{
+
+// Runs the ops of a CPU device on a background stream, so that host code overlaps with them.
+// Ops return as soon as they are queued and run in submission order, reads from the host wait for
+// the event of the buffer they read. Buffers use the host storage of the wrapped device, and
+// their memory is freed on the stream, after the ops still using it.
+class AsyncDevice final : public Device
+{
+private:
+  DevicePtr inner;
+  std::shared_ptr<Stream> stream;
+
+  // Makes the memory of `handle` freed on the stream.
+  [[nodiscard]] HandlePtr defer_free(HandlePtr handle) const;
+
+  // Queues `op(*inner, buffers...)` on the stream.
+  template <class Op, class... Buffers>
+  void enqueue(Op const &op, Buffers const &...buffers) const;
+
+public:
+  explicit AsyncDevice(DevicePtr device);
+
+  AsyncDevice(AsyncDevice const &)            = delete;
+  AsyncDevice(AsyncDevice &&)                 = delete;
+  AsyncDevice &operator=(AsyncDevice const &) = delete;
+  AsyncDevice &operator=(AsyncDevice &&)      = delete;
+  // Waits for the queued ops, which use the wrapped device.
+  ~AsyncDevice() override;
+
+  [[nodiscard]] DeviceType type() const override { return this->inner->type(); }
+
+  [[nodiscard]] size_t num_threads() const override { return this->inner->num_threads(); }
+
+  void add(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sub(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void mul(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void cmul(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void cdiv(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sadd(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void ssub(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void smul(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sdiv(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void axpy(Buffer const &alpha, Buffer const &x, Buffer &y) const override;
+
+  void axpby(Buffer const &alpha, Buffer const &x, Buffer const &beta, Buffer &y) const override;
+
+  void dot(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sum(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void max(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void min(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void norm2(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void eval(ExprProgram const &program, Buffer &out) const override;
+
+  [[nodiscard]] Buffer new_buffer(std::vector<float> data, Shape shape) const override;
+
+  [[nodiscard]] Buffer new_buffer_uninitialized(Shape shape) const override;
+
+  [[nodiscard]] HandlePtr adopt_host_storage(HandlePtr handle) const override;
+
+  void fill(Buffer &buffer, float value) const override;
+
+  void fill_random(Buffer &buffer, Distribution dist, uint64_t seed) const override;
+
+  void copy_buffer(Buffer const &from, Buffer &to) const override;
+
+  void transpose(Buffer const &from, Buffer &to) const override;
+
+  [[nodiscard]] std::vector<float> cpu(Buffer const &buffer) const override;
+
+  [[nodiscard]] float const *host_data(Buffer const &buffer) const override;
+
+  void sync(Buffer const &buffer) const override;
+};
+
+} // namespace gpu_playground::backend
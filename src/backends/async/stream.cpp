@@ -0,0 +1,99 @@
+#include "stream.hpp"
+
+namespace gpu_playground::backend
+{
+
+Stream::Stream() : worker([this]() { this->worker_loop(); }) {}
+
+Stream::~Stream()
+{
+  {
+    std::lock_guard<std::mutex> const lock{this->mutex};
+    this->stop = true;
+  }
+  this->wake.notify_one();
+  this->worker.join();
+}
+
+void Stream::worker_loop()
+{
+  std::unique_lock<std::mutex> lock{this->mutex};
+  while (true)
+  {
+    this->wake.wait(lock, [this]() { return this->stop or not this->queue.empty(); });
+    if (this->queue.empty())
+    {
+      return;
+    }
+
+    auto entry = std::move(this->queue.front());
+    this->queue.pop_front();
+
+    lock.unlock();
+    entry.job();
+    entry.job = nullptr;
+    lock.lock();
+
+    this->completed = entry.ticket;
+    this->done.notify_all();
+  }
+}
+
+void Stream::wait_ticket(std::unique_lock<std::mutex> &lock, uint64_t const ticket)
+{
+  this->done.wait(lock, [this, ticket]() { return this->completed >= ticket; });
+}
+
+void Stream::submit(std::function<void()> job, std::vector<void const *> const &buffers)
+{
+  {
+    std::lock_guard<std::mutex> const lock{this->mutex};
+    uint64_t const ticket = ++this->submitted;
+    for (auto const *data : buffers)
+    {
+      this->events[data] = ticket;
+    }
+    this->queue.push_back({ticket, std::move(job)});
+  }
+  this->wake.notify_one();
+}
+
+void Stream::retire(void *data, std::function<void(void *)> free)
+{
+  {
+    std::lock_guard<std::mutex> const lock{this->mutex};
+    this->events.erase(data);
+    this->queue.push_back(
+        {++this->submitted, [data, free = std::move(free)]() -> void { free(data); }}
+    );
+  }
+  this->wake.notify_one();
+}
+
+void Stream::wait(void const *data)
+{
+  std::unique_lock<std::mutex> lock{this->mutex};
+  auto const event = this->events.find(data);
+  if (event == this->events.end())
+  {
+    return;
+  }
+
+  uint64_t const ticket = event->second;
+  this->wait_ticket(lock, ticket);
+
+  // A later job may have taken over the event while waiting.
+  auto const current = this->events.find(data);
+  if (current != this->events.end() and current->second <= this->completed)
+  {
+    this->events.erase(current);
+  }
+}
+
+void Stream::finish()
+{
+  std::unique_lock<std::mutex> lock{this->mutex};
+  this->wait_ticket(lock, this->submitted);
+}
+
+} // namespace gpu_playground::backend
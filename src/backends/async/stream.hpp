@@ -0,0 +1,71 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gpu_playground::backend
+{
+
+// An in-order queue of jobs run by a background thread, the CPU counterpart of a Metal command
+// queue. Every job gets a ticket, and the stream remembers, per buffer, the ticket of the last
+// job using it: that ticket is the completion event of the buffer. Waiting on a buffer waits for
+// its event only, not for the jobs submitted after it.
+class Stream
+{
+private:
+  struct Entry
+  {
+    uint64_t ticket;
+    std::function<void()> job;
+  };
+
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  std::deque<Entry> queue;
+  // The event of every buffer, keyed by its memory.
+  std::unordered_map<void const *, uint64_t> events;
+  uint64_t submitted{0};
+  uint64_t completed{0};
+  bool stop{false};
+
+  // Declared last, so that it starts once the state above is initialised.
+  std::thread worker;
+
+  void worker_loop();
+
+  // Waits until the job with `ticket` has completed, the lock on `mutex` being held.
+  void wait_ticket(std::unique_lock<std::mutex> &lock, uint64_t ticket);
+
+public:
+  Stream();
+
+  Stream(Stream const &)            = delete;
+  Stream(Stream &&)                 = delete;
+  Stream &operator=(Stream const &) = delete;
+  Stream &operator=(Stream &&)      = delete;
+
+  // Runs the jobs still queued, then stops the worker.
+  ~Stream();
+
+  // Queues `job`, which becomes the event of every buffer in `buffers`.
+  void submit(std::function<void()> job, std::vector<void const *> const &buffers);
+
+  // Queues `free(data)` after the jobs using `data`, and forgets its event.
+  void retire(void *data, std::function<void(void *)> free);
+
+  // Waits for the event of the buffer at `data`, returns at once when it has none.
+  void wait(void const *data);
+
+  // Waits for every job submitted so far.
+  void finish();
+};
+
+} // namespace gpu_playground::backend
@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "auto_device.hpp"
+#include "host_storage.hpp"
+
+namespace gpu_playground::backend
+{
+
+namespace
+{
+
+// What sets the speed of a device apart from another one of the same type.
+using DeviceConfig = std::pair<DeviceType, size_t>;
+
+std::atomic<size_t> calibrations{0};
+
+// Calibrates once per process for every set of backends and thread counts, as tests and
+// benchmarks create devices over and over.
+[[nodiscard]] std::shared_ptr<CostModel const>
+calibrated_model(std::vector<DevicePtr> const &devices)
+{
+  static std::mutex mutex;
+  static std::map<std::vector<DeviceConfig>, std::shared_ptr<CostModel const>> models;
+
+  std::vector<DeviceConfig> configs;
+  configs.reserve(devices.size());
+  for (auto const &device : devices)
+  {
+    configs.emplace_back(device->type(), device->num_threads());
+  }
+
+  std::lock_guard<std::mutex> const lock{mutex};
+  auto &model = models[configs];
+  if (model == nullptr)
+  {
+    model = std::make_shared<CostModel const>(CostModel::calibrate(devices));
+    calibrations++;
+  }
+  return model;
+}
+
+} // namespace
+
+AutoDevice::AutoDevice(std::vector<DevicePtr> devices) : devices(std::move(devices))
+{
+  assert(not this->devices.empty() and "The auto device needs at least one device");
+  assert(
+      std::all_of(
+          this->devices.cbegin(),
+          this->devices.cend(),
+          [](DevicePtr const &device) { return is_host_device(device->type()); }
+      ) and
+      "The auto device only runs on CPU devices"
+  );
+}
+
+Device const &AutoDevice::pick(OpClass const op, size_t const work) const
+{
+  std::call_once(this->calibrated, [this]() { this->model = calibrated_model(this->devices); });
+  return *this->devices[this->model->pick(op, work)];
+}
+
+void AutoDevice::add(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->pick(OpClass::CWISE, c.size()).add(a, b, c);
+}
+
+void AutoDevice::sub(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->pick(OpClass::CWISE, c.size()).sub(a, b, c);
+}
+
+void AutoDevice::mul(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  auto const [m, k] = a.shape();
+  auto const n      = b.shape().cols;
+  auto const op     = (m == 1 or n == 1) ? OpClass::GEMV : OpClass::GEMM;
+  this->pick(op, m * k * n).mul(a, b, c);
+}
+
+void AutoDevice::cmul(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->pick(OpClass::CWISE, c.size()).cmul(a, b, c);
+}
+
+void AutoDevice::cdiv(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->pick(OpClass::CWISE, c.size()).cdiv(a, b, c);
+}
+
+void AutoDevice::sadd(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->pick(OpClass::CWISE, c.size()).sadd(a, b, c);
+}
+
+void AutoDevice::ssub(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->pick(OpClass::CWISE, c.size()).ssub(a, b, c);
+}
+
+void AutoDevice::smul(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->pick(OpClass::CWISE, c.size()).smul(a, b, c);
+}
+
+void AutoDevice::sdiv(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->pick(OpClass::CWISE, c.size()).sdiv(a, b, c);
+}
+
+void AutoDevice::axpy(Buffer const &alpha, Buffer const &x, Buffer &y) const
+{
+  this->pick(OpClass::CWISE, y.size()).axpy(alpha, x, y);
+}
+
+void AutoDevice::axpby(Buffer const &alpha, Buffer const &x, Buffer const &beta, Buffer &y) const
+{
+  this->pick(OpClass::CWISE, y.size()).axpby(alpha, x, beta, y);
+}
+
+void AutoDevice::dot(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->pick(OpClass::DOT, a.size()).dot(a, b, c);
+}
+
+void AutoDevice::sum(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->pick(OpClass::REDUCE, a.size()).sum(a, c, axis);
+}
+
+void AutoDevice::max(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->pick(OpClass::REDUCE, a.size()).max(a, c, axis);
+}
+
+void AutoDevice::min(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->pick(OpClass::REDUCE, a.size()).min(a, c, axis);
+}
+
+void AutoDevice::norm2(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->pick(OpClass::REDUCE, a.size()).norm2(a, c, axis);
+}
+
+void AutoDevice::eval(ExprProgram const &program, Buffer &out) const
+{
+  this->pick(OpClass::CWISE, out.size()).eval(program, out);
+}
+
+// Buffers come from the device that would run element-wise ops on them, so that their pages are
+// written and placed the way that device does it, then they are retagged.
+Buffer AutoDevice::new_buffer(std::vector<float> data, Shape shape) const
+{
+  auto const &device = this->pick(OpClass::CWISE, shape.rows * shape.cols);
+  auto buffer        = device.new_buffer(std::move(data), shape);
+  return Buffer{buffer.take_handle(), shape, AutoDevice::s_type};
+}
+
+Buffer AutoDevice::new_buffer_uninitialized(Shape shape) const
+{
+  auto const &device = this->pick(OpClass::CWISE, shape.rows * shape.cols);
+  auto buffer        = device.new_buffer_uninitialized(shape);
+  return Buffer{buffer.take_handle(), shape, AutoDevice::s_type};
+}
+
+void AutoDevice::fill(Buffer &buffer, float const value) const
+{
+  this->pick(OpClass::CWISE, buffer.size()).fill(buffer, value);
+}
+
+void AutoDevice::fill_random(Buffer &buffer, Distribution const dist, uint64_t const seed) const
+{
+  this->pick(OpClass::CWISE, buffer.size()).fill_random(buffer, dist, seed);
+}
+
+void AutoDevice::copy_buffer(Buffer const &from, Buffer &to) const
+{
+  this->pick(OpClass::CWISE, to.size()).copy_buffer(from, to);
+}
+
+void AutoDevice::transpose(Buffer const &from, Buffer &to) const
+{
+  this->pick(OpClass::TRANSPOSE, to.size()).transpose(from, to);
+}
+
+std::vector<float> AutoDevice::cpu(Buffer const &buffer) const
+{
+  auto const *auto_buffer = host_ptr(buffer);
+  return {auto_buffer, std::next(auto_buffer, buffer.size())};
+}
+
+float const *AutoDevice::host_data(Buffer const &buffer) const
+{
+  return host_ptr(buffer);
+}
+
+// The devices run their ops synchronously, there is nothing to wait for.
+void AutoDevice::sync([[maybe_unused]] Buffer const &buffer) const {}
+
+} // namespace gpu_playground::backend
+
+gpu_playground::DevicePtr gpu_playground::make_auto_device(std::vector<DevicePtr> devices)
+{
+  return std::make_shared<gpu_playground::backend::AutoDevice>(std::move(devices));
+}
+
+size_t gpu_playground::auto_device_calibrations()
+{
+  return gpu_playground::backend::calibrations.load();
+}
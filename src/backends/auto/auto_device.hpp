@@ -0,0 +1,91 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "cost_model.hpp"
+#include "device.hpp"
+
+namespace gpu_playground::backend
+{
+
+// Runs every op on the CPU device the cost model finds fastest for its class and size. All of
+// them use the shared host storage, so a buffer is used in place by whichever device runs the op.
+// The model is only looked up, or calibrated, by the first op.
+class AutoDevice final : public Device
+{
+private:
+  static constexpr DeviceType s_type{DeviceType::AUTO};
+
+  std::vector<DevicePtr> devices;
+  mutable std::once_flag calibrated;
+  mutable std::shared_ptr<CostModel const> model;
+
+  [[nodiscard]] Device const &pick(OpClass op, size_t work) const;
+
+public:
+  explicit AutoDevice(std::vector<DevicePtr> devices);
+
+  AutoDevice(AutoDevice const &)            = delete;
+  AutoDevice(AutoDevice &&)                 = delete;
+  AutoDevice &operator=(AutoDevice const &) = delete;
+  AutoDevice &operator=(AutoDevice &&)      = delete;
+  ~AutoDevice() override                    = default;
+
+  [[nodiscard]] DeviceType type() const override { return AutoDevice::s_type; }
+
+  void add(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sub(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void mul(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void cmul(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void cdiv(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sadd(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void ssub(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void smul(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sdiv(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void axpy(Buffer const &alpha, Buffer const &x, Buffer &y) const override;
+
+  void axpby(Buffer const &alpha, Buffer const &x, Buffer const &beta, Buffer &y) const override;
+
+  void dot(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sum(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void max(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void min(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void norm2(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void eval(ExprProgram const &program, Buffer &out) const override;
+
+  [[nodiscard]] Buffer new_buffer(std::vector<float> data, Shape shape) const override;
+
+  [[nodiscard]] Buffer new_buffer_uninitialized(Shape shape) const override;
+
+  void fill(Buffer &buffer, float value) const override;
+
+  void fill_random(Buffer &buffer, Distribution dist, uint64_t seed) const override;
+
+  void copy_buffer(Buffer const &from, Buffer &to) const override;
+
+  void transpose(Buffer const &from, Buffer &to) const override;
+
+  [[nodiscard]] std::vector<float> cpu(Buffer const &buffer) const override;
+
+  [[nodiscard]] float const *host_data(Buffer const &buffer) const override;
+
+  void sync(Buffer const &buffer) const override;
+};
+
+} // namespace gpu_playground::backend
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "cost_model.hpp"
+
+namespace gpu_playground::backend
+{
+
+namespace
+{
+
+constexpr size_t n_samples{5};
+
+using Samples = std::array<std::array<size_t, n_samples>, static_cast<size_t>(OpClass::COUNT)>;
+
+// The sizes every class is timed at, in the order of OpClass: a length for vectors, a side for
+// square matrices. They go from a few cache lines to well past the last level cache.
+constexpr Samples samples{{
+    {size_t{1} << 6, size_t{1} << 10, size_t{1} << 14, size_t{1} << 18, size_t{1} << 21},
+    {size_t{1} << 6, size_t{1} << 10, size_t{1} << 14, size_t{1} << 18, size_t{1} << 21},
+    {size_t{1} << 6, size_t{1} << 10, size_t{1} << 14, size_t{1} << 18, size_t{1} << 21},
+    {8, 32, 128, 512, 1024},
+    {4, 16, 64, 128, 256},
+    {8, 32, 128, 512, 1024},
+}};
+
+// A timed batch repeats an op until it has done about this much work, so that a batch of small
+// ops lasts well over the resolution of the clock.
+constexpr size_t batch_work{size_t{1} << 18};
+constexpr size_t n_batches{5};
+
+[[nodiscard]] size_t work_of(OpClass const op, size_t const sample)
+{
+  switch (op)
+  {
+  case OpClass::GEMV:
+  case OpClass::TRANSPOSE:
+    return sample * sample;
+  case OpClass::GEMM:
+    return sample * sample * sample;
+  default:
+    return sample;
+  }
+}
+
+// The time of one call of `op`, the best over a few batches after a first call warms up the
+// caches. Large ops whose first call is already well behind `bound`, the best time so far, are not
+// timed any further: they will not be picked, and each call is costly.
+template <class Op>
+[[nodiscard]] double time_op(size_t const work, double const bound, Op const &op)
+{
+  using Clock = std::chrono::steady_clock;
+
+  size_t const reps = std::max<size_t>(1, batch_work / work);
+
+  auto const warm_start = Clock::now();
+  op();
+  auto const warm = std::chrono::duration<double>(Clock::now() - warm_start).count();
+  if (reps == 1 and warm > 2.0 * bound)
+  {
+    return warm;
+  }
+
+  double best = std::numeric_limits<double>::infinity();
+  for (size_t b{0}; b < n_batches; b++)
+  {
+    auto const start = Clock::now();
+    for (size_t r{0}; r < reps; r++)
+    {
+      op();
+    }
+    auto const elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    best               = std::min(best, elapsed / static_cast<double>(reps));
+  }
+  return best;
+}
+
+// Outputs are written once beforehand, so that no call pays for the first touch of their pages.
+[[nodiscard]] double
+time_sample(Device const &device, OpClass const op, size_t const sample, double const bound)
+{
+  size_t const work = work_of(op, sample);
+  Shape const vector{sample, 1};
+  Shape const matrix{sample, sample};
+  Shape const scalar{1, 1};
+
+  switch (op)
+  {
+  case OpClass::CWISE:
+  {
+    auto const a = device.new_buffer(std::vector<float>(sample, 0.5F), vector);
+    auto const b = device.new_buffer(std::vector<float>(sample, 0.25F), vector);
+    auto c       = device.new_buffer(std::vector<float>(sample), vector);
+    return time_op(work, bound, [&]() { device.add(a, b, c); });
+  }
+  case OpClass::REDUCE:
+  {
+    auto const a = device.new_buffer(std::vector<float>(sample, 0.5F), vector);
+    auto c       = device.new_buffer(std::vector<float>(1), scalar);
+    return time_op(work, bound, [&]() { device.sum(a, c, Axis::ALL); });
+  }
+  case OpClass::DOT:
+  {
+    auto const a = device.new_buffer(std::vector<float>(sample, 0.5F), vector);
+    auto const b = device.new_buffer(std::vector<float>(sample, 0.25F), vector);
+    auto c       = device.new_buffer(std::vector<float>(1), scalar);
+    return time_op(work, bound, [&]() { device.dot(a, b, c); });
+  }
+  case OpClass::GEMV:
+  {
+    auto const a = device.new_buffer(std::vector<float>(sample * sample, 0.5F), matrix);
+    auto const x = device.new_buffer(std::vector<float>(sample, 0.5F), vector);
+    auto y       = device.new_buffer(std::vector<float>(sample), vector);
+    return time_op(work, bound, [&]() { device.mul(a, x, y); });
+  }
+  case OpClass::GEMM:
+  {
+    auto const a = device.new_buffer(std::vector<float>(sample * sample, 0.5F), matrix);
+    auto c       = device.new_buffer(std::vector<float>(sample * sample), matrix);
+    return time_op(work, bound, [&]() { device.mul(a, a, c); });
+  }
+  case OpClass::TRANSPOSE:
+  {
+    auto const a = device.new_buffer(std::vector<float>(sample * sample, 0.5F), matrix);
+    auto c       = device.new_buffer(std::vector<float>(sample * sample), matrix);
+    return time_op(work, bound, [&]() { device.transpose(a, c); });
+  }
+  case OpClass::COUNT:
+    break;
+  }
+  return std::numeric_limits<double>::infinity();
+}
+
+} // namespace
+
+CostModel CostModel::calibrate(std::vector<DevicePtr> const &devices)
+{
+  assert(not devices.empty() and "The cost model needs at least one device");
+
+  CostModel model;
+  for (size_t o{0}; o < static_cast<size_t>(OpClass::COUNT); o++)
+  {
+    auto const op = static_cast<OpClass>(o);
+
+    std::array<size_t, n_samples> fastest{};
+    for (size_t s{0}; s < n_samples; s++)
+    {
+      double best = std::numeric_limits<double>::infinity();
+      for (size_t d{0}; d < devices.size(); d++)
+      {
+        double const seconds = time_sample(*devices[d], op, samples[o][s], best);
+        if (seconds < best)
+        {
+          best       = seconds;
+          fastest[s] = d;
+        }
+      }
+    }
+
+    // A range ends halfway to the next size won by another device.
+    auto &ranges = model.ranges[o];
+    for (size_t s{0}; s < n_samples; s++)
+    {
+      if (s + 1 < n_samples and fastest[s + 1] == fastest[s])
+      {
+        continue;
+      }
+      size_t max_work = std::numeric_limits<size_t>::max();
+      if (s + 1 < n_samples)
+      {
+        double const lhs = static_cast<double>(work_of(op, samples[o][s]));
+        double const rhs = static_cast<double>(work_of(op, samples[o][s + 1]));
+        max_work         = static_cast<size_t>(std::sqrt(lhs * rhs));
+      }
+      ranges.push_back({max_work, fastest[s]});
+    }
+  }
+  return model;
+}
+
+} // namespace gpu_playground::backend
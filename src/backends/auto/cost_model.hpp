@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "device.hpp"
+
+namespace gpu_playground::backend
+{
+
+// The kinds of kernel the cost model tells apart, each one timed on its own.
+enum class OpClass : uint8_t
+{
+  // Element-wise and scalar ops, axpy, fill, copy and fused expressions, per element written.
+  CWISE,
+  // Reductions, per element read.
+  REDUCE,
+  // Dot products, per pair of elements read.
+  DOT,
+  // Products with a vector operand, per multiply-add.
+  GEMV,
+  // Products of matrices, per multiply-add.
+  GEMM,
+  // Transposes, per element.
+  TRANSPOSE,
+  COUNT
+};
+
+// Picks the device to run an op on from its class and its amount of work. Every class is timed on
+// every device at a few sizes, each size going to the device that ran it fastest. Between two
+// sizes the choice switches halfway, on a logarithmic scale.
+class CostModel
+{
+private:
+  struct Range
+  {
+    // The largest amount of work `device` is picked for.
+    size_t max_work;
+    size_t device;
+  };
+
+  // The ranges of every class, by increasing work, the last one unbounded.
+  std::array<std::vector<Range>, static_cast<size_t>(OpClass::COUNT)> ranges;
+
+public:
+  // Times every class on `devices`, which takes a fraction of a second.
+  [[nodiscard]] static CostModel calibrate(std::vector<DevicePtr> const &devices);
+
+  // The index, among the calibrated devices, of the fastest one for `work` units of `op`.
+  [[nodiscard]] size_t pick(OpClass const op, size_t const work) const
+  {
+    auto const &op_ranges = this->ranges[static_cast<size_t>(op)];
+    for (size_t r{0}; r + 1 < op_ranges.size(); r++)
+    {
+      if (work <= op_ranges[r].max_work)
+      {
+        return op_ranges[r].device;
+      }
+    }
+    return op_ranges.back().device;
+  }
+};
+
+} // namespace gpu_playground::backend
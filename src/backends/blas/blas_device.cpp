@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <vector>
+
+#include "buffer.hpp"
+#include "cblas.h"
+#include "host_storage.hpp"
+#include "reproducible.hpp"
+
+#include "blas_device.hpp"
+
+namespace gpu_playground::backend
+{
+
+namespace
+{
+
+// CBLAS takes sizes and strides as int.
+[[nodiscard]] int blas_size(size_t const size)
+{
+  assert(size <= static_cast<size_t>(INT_MAX) and "Buffer too large for the BLAS interface");
+  return static_cast<int>(size);
+}
+
+// A leading dimension, which BLAS requires to be at least one even for empty matrices.
+[[nodiscard]] int blas_stride(size_t const cols) { return blas_size(std::max<size_t>(1, cols)); }
+
+} // namespace
+
+BlasDevice::BlasDevice() : host(make_serial_device()) {}
+
+void BlasDevice::add(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->host->add(a, b, c);
+}
+
+void BlasDevice::sub(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->host->sub(a, b, c);
+}
+
+void BlasDevice::mul(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  assert_compatible_mul(a, b, c);
+
+  auto const [m, k] = a.shape();
+  auto const n      = b.shape().cols;
+
+  auto const *blas_a = host_ptr(a);
+  auto const *blas_b = host_ptr(b);
+  auto *blas_c       = host_ptr(c);
+
+  // Matrix-vector products go through gemv, which streams the matrix once instead of packing it.
+  if (n == 1)
+  {
+    cblas_sgemv(
+        CblasRowMajor,
+        CblasNoTrans,
+        blas_size(m),
+        blas_size(k),
+        1.0F,
+        blas_a,
+        blas_stride(k),
+        blas_b,
+        1,
+        0.0F,
+        blas_c,
+        1
+    );
+  }
+  else if (m == 1)
+  {
+    cblas_sgemv(
+        CblasRowMajor,
+        CblasTrans,
+        blas_size(k),
+        blas_size(n),
+        1.0F,
+        blas_b,
+        blas_stride(n),
+        blas_a,
+        1,
+        0.0F,
+        blas_c,
+        1
+    );
+  }
+  else
+  {
+    cblas_sgemm(
+        CblasRowMajor,
+        CblasNoTrans,
+        CblasNoTrans,
+        blas_size(m),
+        blas_size(n),
+        blas_size(k),
+        1.0F,
+        blas_a,
+        blas_stride(k),
+        blas_b,
+        blas_stride(n),
+        0.0F,
+        blas_c,
+        blas_stride(n)
+    );
+  }
+}
+
+void BlasDevice::cmul(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->host->cmul(a, b, c);
+}
+
+void BlasDevice::cdiv(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->host->cdiv(a, b, c);
+}
+
+void BlasDevice::sadd(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->host->sadd(a, b, c);
+}
+
+void BlasDevice::ssub(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->host->ssub(a, b, c);
+}
+
+void BlasDevice::smul(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  assert_compatible_sop(a, b, c);
+
+  auto const size = blas_size(c.size());
+  auto *blas_c    = host_ptr(c);
+  if (host_ptr(a) != blas_c)
+  {
+    cblas_scopy(size, host_ptr(a), 1, blas_c, 1);
+  }
+  cblas_sscal(size, host_ptr(b)[0], blas_c, 1);
+}
+
+// Division stays exact on the serial kernels, scaling by the reciprocal would round differently.
+void BlasDevice::sdiv(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  this->host->sdiv(a, b, c);
+}
+
+void BlasDevice::axpy(Buffer const &alpha, Buffer const &x, Buffer &y) const
+{
+  assert_compatible_axpy(alpha, x, y);
+
+  // BLAS does not allow its vectors to overlap.
+  if (host_ptr(x) == host_ptr(y))
+  {
+    this->host->axpy(alpha, x, y);
+    return;
+  }
+
+  cblas_saxpy(blas_size(y.size()), host_ptr(alpha)[0], host_ptr(x), 1, host_ptr(y), 1);
+}
+
+void BlasDevice::axpby(Buffer const &alpha, Buffer const &x, Buffer const &beta, Buffer &y) const
+{
+  assert_compatible_axpy(alpha, x, y);
+  assert_compatible_axpy(beta, x, y);
+
+  // Scaling y first would scale x along with it.
+  if (host_ptr(x) == host_ptr(y))
+  {
+    this->host->axpby(alpha, x, beta, y);
+    return;
+  }
+
+  auto const size = blas_size(y.size());
+  cblas_sscal(size, host_ptr(beta)[0], host_ptr(y), 1);
+  cblas_saxpy(size, host_ptr(alpha)[0], host_ptr(x), 1, host_ptr(y), 1);
+}
+
+void BlasDevice::dot(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::dot(a, b, c);
+    return;
+  }
+
+  assert_compatible_dot(a, b, c);
+  host_ptr(c)[0] = cblas_sdot(blas_size(a.size()), host_ptr(a), 1, host_ptr(b), 1);
+}
+
+void BlasDevice::sum(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->host->sum(a, c, axis);
+}
+
+void BlasDevice::max(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->host->max(a, c, axis);
+}
+
+void BlasDevice::min(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->host->min(a, c, axis);
+}
+
+void BlasDevice::norm2(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions() or axis != Axis::ALL)
+  {
+    this->host->norm2(a, c, axis);
+    return;
+  }
+
+  assert_compatible_reduce(a, c, axis);
+  host_ptr(c)[0] = cblas_snrm2(blas_size(a.size()), host_ptr(a), 1);
+}
+
+void BlasDevice::eval(ExprProgram const &program, Buffer &out) const
+{
+  this->host->eval(program, out);
+}
+
+Buffer BlasDevice::new_buffer(std::vector<float> data, Shape shape) const
+{
+  auto buffer = this->new_buffer_uninitialized(shape);
+  std::copy(data.cbegin(), data.cend(), host_ptr(buffer));
+  return buffer;
+}
+
+Buffer BlasDevice::new_buffer_uninitialized(Shape shape) const
+{
+  return Buffer{new_host_storage(shape.rows * shape.cols), shape, BlasDevice::s_type};
+}
+
+void BlasDevice::fill(Buffer &buffer, float const value) const
+{
+  this->host->fill(buffer, value);
+}
+
+void BlasDevice::copy_buffer(Buffer const &from, Buffer &to) const
+{
+  assert_compatible_copy(from, to);
+  cblas_scopy(blas_size(from.size()), host_ptr(from), 1, host_ptr(to), 1);
+}
+
+void BlasDevice::transpose(Buffer const &from, Buffer &to) const
+{
+  this->host->transpose(from, to);
+}
+
+std::vector<float> BlasDevice::cpu(Buffer const &buffer) const
+{
+  auto const *blas_buffer = host_ptr(buffer);
+  return {blas_buffer, std::next(blas_buffer, buffer.size())};
+}
+
+float const *BlasDevice::host_data(Buffer const &buffer) const
+{
+  return host_ptr(buffer);
+}
+
+void BlasDevice::sync([[maybe_unused]] Buffer const &buffer) const {}
+
+} // namespace gpu_playground::backend
+
+gpu_playground::DevicePtr gpu_playground::make_blas_device()
+{
+  return std::make_shared<gpu_playground::backend::BlasDevice>();
+}
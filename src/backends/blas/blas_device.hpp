@@ -0,0 +1,82 @@
+#pragma once
+
+#include "device.hpp"
+
+namespace gpu_playground::backend
+{
+
+// Runs the ops BLAS provides through the CBLAS interface of the library found at build time:
+// products, scaling, axpy, dot, norm and copy. The other ops have no BLAS routine and run on the
+// serial kernels. Sharing the device across threads is safe as long as the BLAS library is, as
+// OpenBLAS is when built with threading support.
+class BlasDevice final : public Device
+{
+private:
+  static constexpr DeviceType s_type{DeviceType::BLAS};
+
+  // Runs the ops BLAS has no routine for. The buffers of both devices share the host layout.
+  DevicePtr host;
+
+public:
+  BlasDevice();
+
+  BlasDevice(BlasDevice const &)            = default;
+  BlasDevice(BlasDevice &&)                 = delete;
+  BlasDevice &operator=(BlasDevice const &) = default;
+  BlasDevice &operator=(BlasDevice &&)      = delete;
+  ~BlasDevice() override                    = default;
+
+  [[nodiscard]] DeviceType type() const override { return BlasDevice::s_type; }
+
+  void add(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sub(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void mul(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void cmul(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void cdiv(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sadd(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void ssub(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void smul(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sdiv(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void axpy(Buffer const &alpha, Buffer const &x, Buffer &y) const override;
+
+  void axpby(Buffer const &alpha, Buffer const &x, Buffer const &beta, Buffer &y) const override;
+
+  void dot(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sum(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void max(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void min(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void norm2(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void eval(ExprProgram const &program, Buffer &out) const override;
+
+  [[nodiscard]] Buffer new_buffer(std::vector<float> data, Shape shape) const override;
+
+  [[nodiscard]] Buffer new_buffer_uninitialized(Shape shape) const override;
+
+  void fill(Buffer &buffer, float value) const override;
+
+  void copy_buffer(Buffer const &from, Buffer &to) const override;
+
+  void transpose(Buffer const &from, Buffer &to) const override;
+
+  [[nodiscard]] std::vector<float> cpu(Buffer const &buffer) const override;
+
+  [[nodiscard]] float const *host_data(Buffer const &buffer) const override;
+
+  void sync(Buffer const &buffer) const override;
+};
+
+} // namespace gpu_playground::backend
@@ -1,60 +1,76 @@
+#include <algorithm>
+#include <vector>
+
 #include "Eigen/Dense"
 #include "buffer.hpp"
+#include "expression_eval.hpp"
+#include "host_storage.hpp"
+#include "reproducible.hpp"
 
 #include "eigen_device.hpp"
 
 namespace gpu_playground::backend
 {
 
-using EigenBuffer = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+using EigenMatrix = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+// Buffers live in the shared host storage, Eigen only maps a matrix over it.
+using EigenBuffer      = Eigen::Map<EigenMatrix, Eigen::Aligned64>;
+using EigenConstBuffer = Eigen::Map<EigenMatrix const, Eigen::Aligned64>;
+
+static_assert(host_alignment % 64 == 0, "Host storage is not aligned for Eigen::Aligned64");
 
 namespace
 {
 
+[[nodiscard]] EigenBuffer eigen_map(Buffer &buffer)
+{
+  auto const [rows, cols] = buffer.shape();
+  return {host_ptr(buffer), static_cast<Eigen::Index>(rows), static_cast<Eigen::Index>(cols)};
+}
+
+[[nodiscard]] EigenConstBuffer eigen_map(Buffer const &buffer)
+{
+  auto const [rows, cols] = buffer.shape();
+  return {host_ptr(buffer), static_cast<Eigen::Index>(rows), static_cast<Eigen::Index>(cols)};
+}
+
+// The functors build expressions over arrays, which the caller assigns straight into the output
+// buffer: Eigen then evaluates them in a single vectorised loop, without a temporary matrix.
 struct Add
 {
-  [[nodiscard]] EigenBuffer operator()(EigenBuffer const &a, EigenBuffer const &b) const
+  template <class Lhs, class Rhs>
+  [[nodiscard]] auto operator()(Lhs const &a, Rhs const &b) const
   {
     return a + b;
   }
-
-  [[nodiscard]] EigenBuffer operator()(EigenBuffer const &a, float const b) const
-  {
-    return a.array() + b;
-  }
 };
 
 struct Sub
 {
-  [[nodiscard]] EigenBuffer operator()(EigenBuffer const &a, EigenBuffer const &b) const
+  template <class Lhs, class Rhs>
+  [[nodiscard]] auto operator()(Lhs const &a, Rhs const &b) const
   {
     return a - b;
   }
-
-  [[nodiscard]] EigenBuffer operator()(EigenBuffer const &a, float const b) const
-  {
-    return a.array() - b;
-  }
 };
 
 struct Mul
 {
-  [[nodiscard]] EigenBuffer operator()(EigenBuffer const &a, EigenBuffer const &b) const
+  template <class Lhs, class Rhs>
+  [[nodiscard]] auto operator()(Lhs const &a, Rhs const &b) const
   {
-    return a.cwiseProduct(b);
+    return a * b;
   }
-
-  [[nodiscard]] EigenBuffer operator()(EigenBuffer const &a, float const b) const { return a * b; }
 };
 
 struct Div
 {
-  [[nodiscard]] EigenBuffer operator()(EigenBuffer const &a, EigenBuffer const &b) const
+  template <class Lhs, class Rhs>
+  [[nodiscard]] auto operator()(Lhs const &a, Rhs const &b) const
   {
-    return a.cwiseQuotient(b);
+    return a / b;
   }
-
-  [[nodiscard]] EigenBuffer operator()(EigenBuffer const &a, float const b) const { return a / b; }
 };
 
 template <class Op>
@@ -62,11 +78,11 @@ void cwisem_op(Buffer const &a, Buffer const &b, Buffer &c, Op const &op)
 {
   assert_same_shape(a, b, c);
 
-  auto const &eigen_a = *static_cast<EigenBuffer const *>(a.get());
-  auto const &eigen_b = *static_cast<EigenBuffer const *>(b.get());
-  auto &eigen_c       = *static_cast<EigenBuffer *>(c.get());
+  auto const eigen_a = eigen_map(a);
+  auto const eigen_b = eigen_map(b);
+  auto eigen_c       = eigen_map(c);
 
-  eigen_c = op(eigen_a, eigen_b);
+  eigen_c.array() = op(eigen_a.array(), eigen_b.array());
 }
 
 template <class Op>
@@ -74,12 +90,120 @@ void cwises_op(Buffer const &a, Buffer const &b, Buffer &c, Op const &op)
 {
   assert_compatible_sop(a, b, c);
 
-  auto const &eigen_a = *static_cast<EigenBuffer const *>(a.get());
-  auto const &eigen_b = *static_cast<EigenBuffer const *>(b.get());
-  auto &eigen_c       = *static_cast<EigenBuffer *>(c.get());
+  auto const eigen_a = eigen_map(a);
+  auto const eigen_b = eigen_map(b);
+  auto eigen_c       = eigen_map(c);
 
   auto const scalar_b = eigen_b(0);
-  eigen_c             = op(eigen_a, scalar_b);
+  eigen_c.array()     = op(eigen_a.array(), scalar_b);
+}
+
+struct Sum
+{
+  template <class Expr>
+  [[nodiscard]] auto operator()(Expr const &expr) const
+  {
+    return expr.sum();
+  }
+};
+
+struct Max
+{
+  template <class Expr>
+  [[nodiscard]] auto operator()(Expr const &expr) const
+  {
+    return expr.maxCoeff();
+  }
+};
+
+struct Min
+{
+  template <class Expr>
+  [[nodiscard]] auto operator()(Expr const &expr) const
+  {
+    return expr.minCoeff();
+  }
+};
+
+struct Norm2
+{
+  template <class Expr>
+  [[nodiscard]] auto operator()(Expr const &expr) const
+  {
+    return expr.norm();
+  }
+};
+
+template <class Op>
+void reduce_op(Buffer const &a, Buffer &c, Axis const axis, Op const &op)
+{
+  assert_compatible_reduce(a, c, axis);
+
+  auto const eigen_a = eigen_map(a);
+  auto eigen_c       = eigen_map(c);
+
+  switch (axis)
+  {
+  case Axis::ROWS:
+    eigen_c = op(eigen_a.rowwise());
+    break;
+  case Axis::COLS:
+    eigen_c = op(eigen_a.colwise());
+    break;
+  case Axis::ALL:
+    eigen_c(0) = op(eigen_a);
+    break;
+  }
+}
+
+using EvalBlock = Eigen::Map<Eigen::ArrayXf const>;
+
+template <class Lhs, class Rhs>
+void eval_block_op(ExprOp const op, Lhs const &lhs, Rhs const &rhs, Eigen::Map<Eigen::ArrayXf> dst)
+{
+  switch (op)
+  {
+  case ExprOp::ADD:
+    dst = lhs + rhs;
+    break;
+  case ExprOp::SUB:
+    dst = lhs - rhs;
+    break;
+  case ExprOp::MUL:
+    dst = lhs * rhs;
+    break;
+  case ExprOp::DIV:
+    dst = lhs / rhs;
+    break;
+  case ExprOp::LOAD:
+  case ExprOp::LOAD_SCALAR:
+    break;
+  }
+}
+
+void eval_block_op(
+    ExprOp const op, EvalSlot const &lhs, EvalSlot const &rhs, float *dst, Eigen::Index const len
+)
+{
+  Eigen::Map<Eigen::ArrayXf> const eigen_dst(dst, len);
+
+  if (lhs.data != nullptr and rhs.data != nullptr)
+  {
+    eval_block_op(op, EvalBlock(lhs.data, len), EvalBlock(rhs.data, len), eigen_dst);
+  }
+  else if (lhs.data != nullptr)
+  {
+    eval_block_op(op, EvalBlock(lhs.data, len), rhs.scalar, eigen_dst);
+  }
+  else if (rhs.data != nullptr)
+  {
+    eval_block_op(op, lhs.scalar, EvalBlock(rhs.data, len), eigen_dst);
+  }
+  else
+  {
+    Eigen::ArrayXf const lhs_block = Eigen::ArrayXf::Constant(len, lhs.scalar);
+    eval_block_op(op, lhs_block, rhs.scalar, eigen_dst);
+  }
 }
 
 } // namespace
@@ -98,11 +222,13 @@ void EigenDevice::mul(Buffer const &a, Buffer const &b, Buffer &c) const
 {
   assert_compatible_mul(a, b, c);
 
-  auto const &eigen_a = *static_cast<EigenBuffer const *>(a.get());
-  auto const &eigen_b = *static_cast<EigenBuffer const *>(b.get());
-  auto &eigen_c       = *static_cast<EigenBuffer *>(c.get());
+  auto const eigen_a = eigen_map(a);
+  auto const eigen_b = eigen_map(b);
+  auto eigen_c       = eigen_map(c);
 
-  eigen_c = eigen_a * eigen_b;
+  // The output never overlaps the operands, so the product is written straight into it instead
+  // of into a temporary first.
+  eigen_c.noalias() = eigen_a * eigen_b;
 }
 
 void EigenDevice::cmul(Buffer const &a, Buffer const &b, Buffer &c) const
@@ -135,30 +261,136 @@ void EigenDevice::sdiv(Buffer const &a, Buffer const &b, Buffer &c) const
   cwises_op(a, b, c, Div{});
 }
 
+void EigenDevice::axpy(Buffer const &alpha, Buffer const &x, Buffer &y) const
+{
+  assert_compatible_axpy(alpha, x, y);
+
+  auto const eigen_alpha = eigen_map(alpha);
+  auto const eigen_x     = eigen_map(x);
+  auto eigen_y           = eigen_map(y);
+
+  eigen_y += eigen_alpha(0) * eigen_x;
+}
+
+void EigenDevice::axpby(Buffer const &alpha, Buffer const &x, Buffer const &beta, Buffer &y) const
+{
+  assert_compatible_axpy(alpha, x, y);
+  assert_compatible_axpy(beta, x, y);
+
+  auto const eigen_alpha = eigen_map(alpha);
+  auto const eigen_x     = eigen_map(x);
+  auto const eigen_beta  = eigen_map(beta);
+  auto eigen_y           = eigen_map(y);
+
+  eigen_y = (eigen_alpha(0) * eigen_x) + (eigen_beta(0) * eigen_y);
+}
+
+void EigenDevice::dot(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::dot(a, b, c);
+    return;
+  }
+
+  assert_compatible_dot(a, b, c);
+
+  auto const eigen_a = eigen_map(a);
+  auto const eigen_b = eigen_map(b);
+  auto eigen_c       = eigen_map(c);
+
+  auto const size = static_cast<Eigen::Index>(a.size());
+  eigen_c(0)      = Eigen::Map<Eigen::VectorXf const>(eigen_a.data(), size)
+                   .dot(Eigen::Map<Eigen::VectorXf const>(eigen_b.data(), size));
+}
+
+void EigenDevice::sum(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Sum>(a, c, axis);
+    return;
+  }
+
+  reduce_op(a, c, axis, Sum{});
+}
+
+void EigenDevice::max(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Max>(a, c, axis);
+    return;
+  }
+
+  reduce_op(a, c, axis, Max{});
+}
+
+void EigenDevice::min(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Min>(a, c, axis);
+    return;
+  }
+
+  reduce_op(a, c, axis, Min{});
+}
+
+void EigenDevice::norm2(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Norm2>(a, c, axis);
+    return;
+  }
+
+  reduce_op(a, c, axis, Norm2{});
+}
+
+void EigenDevice::eval(ExprProgram const &program, Buffer &out) const
+{
+  assert_compatible_eval(program, out);
+
+  auto const operands = host_operands(program);
+  eval_program(
+      program,
+      operands,
+      host_ptr(out),
+      0,
+      out.size(),
+      [](ExprOp const op, EvalSlot const &lhs, EvalSlot const &rhs, float *dst, size_t const len)
+      { eval_block_op(op, lhs, rhs, dst, static_cast<Eigen::Index>(len)); }
+  );
+}
+
 Buffer EigenDevice::new_buffer(std::vector<float> data, Shape shape) const
 {
-  return Buffer{
-      HandlePtr{
-          new EigenBuffer(
-              Eigen::Map<EigenBuffer>(
-                  data.data(),
-                  static_cast<Eigen::Index>(shape.rows),
-                  static_cast<Eigen::Index>(shape.cols)
-              )
-          ),
-          [](void *ptr) -> void { delete static_cast<EigenBuffer *>(ptr); }
-      },
-      shape,
-      EigenDevice::s_type
-  };
+  auto buffer = this->new_buffer_uninitialized(shape);
+  std::copy(data.cbegin(), data.cend(), host_ptr(buffer));
+  return buffer;
+}
+
+Buffer EigenDevice::new_buffer_uninitialized(Shape shape) const
+{
+  return Buffer{new_host_storage(shape.rows * shape.cols), shape, EigenDevice::s_type};
+}
+
+void EigenDevice::fill(Buffer &buffer, float const value) const
+{
+  assert_compatible_fill(buffer);
+
+  auto eigen_buffer = eigen_map(buffer);
+
+  eigen_buffer.setConstant(value);
 }
 
 void EigenDevice::copy_buffer(Buffer const &from, Buffer &to) const
 {
   assert_compatible_copy(from, to);
 
-  auto const &eigen_from = *static_cast<EigenBuffer const *>(from.get());
-  auto &eigen_to         = *static_cast<EigenBuffer *>(to.get());
+  auto const eigen_from = eigen_map(from);
+  auto eigen_to         = eigen_map(to);
 
   eigen_to = eigen_from;
 }
@@ -167,23 +399,37 @@ void EigenDevice::transpose(Buffer const &from, Buffer &to) const
 {
   assert_compatible_transpose(from, to);
 
-  auto const &eigen_from = *static_cast<EigenBuffer const *>(from.get());
-  auto &eigen_to         = *static_cast<EigenBuffer *>(to.get());
+  auto const eigen_from = eigen_map(from);
+  auto eigen_to         = eigen_map(to);
 
   eigen_to = eigen_from.transpose();
 }
 
 std::vector<float> EigenDevice::cpu(Buffer const &buffer) const
 {
-  auto const &eigen_buffer = *static_cast<EigenBuffer const *>(buffer.get());
+  auto const eigen_buffer = eigen_map(buffer);
   return {eigen_buffer.data(), std::next(eigen_buffer.data(), eigen_buffer.size())};
 }
 
+float const *EigenDevice::host_data(Buffer const &buffer) const
+{
+  return host_ptr(buffer);
+}
+
 void EigenDevice::sync([[maybe_unused]] Buffer const &buffer) const {}
 
+size_t EigenDevice::num_threads() const { return static_cast<size_t>(Eigen::nbThreads()); }
+
 } // namespace gpu_playground::backend
 
 gpu_playground::DevicePtr gpu_playground::make_eigen_device()
 {
   return std::make_shared<gpu_playground::backend::EigenDevice>();
 }
+
+void gpu_playground::set_eigen_threads(size_t const num_threads)
+{
+  Eigen::setNbThreads(static_cast<int>(num_threads));
+}
+
+size_t gpu_playground::eigen_threads() { return static_cast<size_t>(Eigen::nbThreads()); }
@@ -41,14 +41,36 @@ public:
 
   void sdiv(Buffer const &a, Buffer const &b, Buffer &c) const override;
 
+  void axpy(Buffer const &alpha, Buffer const &x, Buffer &y) const override;
+
+  void axpby(Buffer const &alpha, Buffer const &x, Buffer const &beta, Buffer &y) const override;
+
+  void dot(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sum(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void max(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void min(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void norm2(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void eval(ExprProgram const &program, Buffer &out) const override;
+
   [[nodiscard]] Buffer new_buffer(std::vector<float> data, Shape shape) const override;
 
+  [[nodiscard]] Buffer new_buffer_uninitialized(Shape shape) const override;
+
+  void fill(Buffer &buffer, float value) const override;
+
   void copy_buffer(Buffer const &from, Buffer &to) const override;
 
   void transpose(Buffer const &from, Buffer &to) const override;
 
   [[nodiscard]] std::vector<float> cpu(Buffer const &buffer) const override;
 
+  [[nodiscard]] float const *host_data(Buffer const &buffer) const override;
+
   void sync(Buffer const &buffer) const override;
 };
 
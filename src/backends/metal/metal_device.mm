@@ -1,8 +1,12 @@
 #import <Foundation/Foundation.h>
 #import <Metal/Metal.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "metal_device.hpp"
 
@@ -30,6 +34,19 @@ void cmd_swap(id<MTLCommandBuffer> &old_cmd, id<MTLCommandBuffer> &new_cmd)
   old_cmd = new_cmd;
 }
 
+// Threads per threadgroup of the reduction kernels, must match `tg_size` in their shaders.
+constexpr NSUInteger reduce_tg_size = 256;
+
+// Threadgroups per output of a reduction over `count` values: enough for every thread to walk a
+// few values, but no more than keep about 1024 groups in flight across all `outputs`.
+uint32_t reduce_groups(size_t const count, size_t const outputs)
+{
+  size_t const per_group  = reduce_tg_size * 8;
+  size_t const wanted     = (count + per_group - 1) / per_group;
+  size_t const max_groups = std::max<size_t>(1, 1024 / std::max<size_t>(outputs, 1));
+  return static_cast<uint32_t>(std::clamp<size_t>(wanted, 1, max_groups));
+}
+
 } // namespace
 
 namespace gpu_playground::backend
@@ -46,7 +63,11 @@ struct MetalDevice::Impl
   id<MTLDevice> device{nil};
   id<MTLCommandQueue> queue{nil};
   id<MTLLibrary> library{nil};
+  // Filled once at construction, read concurrently afterwards.
   std::unordered_map<std::string, id<MTLComputePipelineState>> ps;
+  // Grows as new fused expressions come in, under `fused_mutex`.
+  std::unordered_map<std::string, id<MTLComputePipelineState>> fused_ps;
+  std::mutex fused_mutex;
 
   Impl() : device(MTLCreateSystemDefaultDevice())
   {
@@ -74,6 +95,14 @@ struct MetalDevice::Impl
     this->add_ps("mat_smul");
     this->add_ps("mat_sdiv");
     this->add_ps("mat_trans");
+    this->add_ps("mat_axpy");
+    this->add_ps("mat_axpby");
+    this->add_ps("mat_dot");
+    this->add_ps("mat_sum");
+    this->add_ps("mat_max");
+    this->add_ps("mat_min");
+    this->add_ps("mat_norm2");
+    this->add_ps("mat_fill");
   }
 
   Impl(Impl const &)            = delete;
@@ -87,6 +116,10 @@ struct MetalDevice::Impl
     {
       [pipeline release];
     }
+    for (auto &[source, pipeline] : this->fused_ps)
+    {
+      [pipeline release];
+    }
     [this->library release];
     [this->queue release];
     [this->device release];
@@ -121,7 +154,7 @@ struct MetalDevice::Impl
 
       id<MTLComputeCommandEncoder> enc = [cmd computeCommandEncoder];
 
-      [enc setComputePipelineState:this->ps[kernel]];
+      [enc setComputePipelineState:this->ps.at(kernel)];
       [enc setBuffer:mtl_a->buffer offset:0 atIndex:0];
       [enc setBuffer:mtl_b->buffer offset:0 atIndex:1];
       [enc setBuffer:mtl_c->buffer offset:0 atIndex:2];
@@ -130,7 +163,7 @@ struct MetalDevice::Impl
 
       MTLSize const gridSize = MTLSizeMake(n, 1, 1);
       NSUInteger const tgSize =
-          std::min<NSUInteger>(this->ps[kernel].maxTotalThreadsPerThreadgroup, n);
+          std::min<NSUInteger>(this->ps.at(kernel).maxTotalThreadsPerThreadgroup, n);
 
       MTLSize const threadgroupSize = MTLSizeMake(tgSize, 1, 1);
 
@@ -158,7 +191,7 @@ struct MetalDevice::Impl
 
       id<MTLComputeCommandEncoder> enc = [cmd computeCommandEncoder];
 
-      [enc setComputePipelineState:this->ps[kernel]];
+      [enc setComputePipelineState:this->ps.at(kernel)];
       [enc setBuffer:mtl_a->buffer offset:0 atIndex:0];
       [enc setBuffer:mtl_b->buffer offset:0 atIndex:1];
       [enc setBuffer:mtl_c->buffer offset:0 atIndex:2];
@@ -167,7 +200,234 @@ struct MetalDevice::Impl
 
       MTLSize const gridSize = MTLSizeMake(n, 1, 1);
       NSUInteger const tgSize =
-          std::min<NSUInteger>(this->ps[kernel].maxTotalThreadsPerThreadgroup, n);
+          std::min<NSUInteger>(this->ps.at(kernel).maxTotalThreadsPerThreadgroup, n);
+
+      MTLSize const threadgroupSize = MTLSizeMake(tgSize, 1, 1);
+
+      [enc dispatchThreads:gridSize threadsPerThreadgroup:threadgroupSize];
+
+      [enc endEncoding];
+      [cmd commit];
+
+      cmd_swap(mtl_c->last_cmd, cmd);
+    }
+  }
+
+  // Expressions are turned into a dedicated kernel, compiled on first use and cached by source,
+  // so each distinct expression shape costs one compilation.
+  id<MTLComputePipelineState> fused_pipeline(ExprProgram const &program)
+  {
+    std::vector<std::string> stack;
+    for (auto const &instr : program.code)
+    {
+      auto const operand = "in" + std::to_string(instr.operand);
+      switch (instr.op)
+      {
+      case ExprOp::LOAD:
+        stack.push_back(operand + "[id]");
+        continue;
+      case ExprOp::LOAD_SCALAR:
+        stack.push_back(operand + "[0]");
+        continue;
+      case ExprOp::ADD:
+      case ExprOp::SUB:
+      case ExprOp::MUL:
+      case ExprOp::DIV:
+        break;
+      }
+
+      char const *symbol = instr.op == ExprOp::ADD   ? " + "
+                           : instr.op == ExprOp::SUB ? " - "
+                           : instr.op == ExprOp::MUL ? " * "
+                                                     : " / ";
+
+      auto rhs = std::move(stack.back());
+      stack.pop_back();
+      stack.back() = "(" + stack.back() + symbol + rhs + ")";
+    }
+
+    std::string source{"#include <metal_stdlib>\n\nusing namespace metal;\n\n"};
+    source += "kernel void mat_fused(\n";
+    for (size_t i{0}; i < program.operands.size(); i++)
+    {
+      auto const idx  = std::to_string(i);
+      source         += "    const device float* in" + idx + " [[buffer(" + idx + ")]],\n";
+    }
+    auto const out_idx  = std::to_string(program.operands.size());
+    source             += "    device float* out [[buffer(" + out_idx + ")]],\n";
+    source             += "    uint id [[thread_position_in_grid]]\n)\n{\n";
+    source             += "    out[id] = " + stack.back() + ";\n}\n";
+
+    std::lock_guard<std::mutex> const lock{this->fused_mutex};
+    auto const it = this->fused_ps.find(source);
+    if (it != this->fused_ps.end())
+    {
+      return it->second;
+    }
+
+    NSString *msl      = [NSString stringWithUTF8String:source.c_str()];
+    NSError *error     = nil;
+    id<MTLLibrary> lib = [this->device newLibraryWithSource:msl options:nil error:&error];
+    assert(lib != nil);
+    assert(error == nil);
+
+    id<MTLFunction> fn = [lib newFunctionWithName:@"mat_fused"];
+    assert(fn != nil);
+
+    id<MTLComputePipelineState> pipeline =
+        [this->device newComputePipelineStateWithFunction:fn error:&error];
+    assert(pipeline != nil);
+    assert(error == nil);
+
+    [fn release];
+    [lib release];
+
+    this->fused_ps[source] = pipeline;
+    return pipeline;
+  }
+
+  // Encodes one pass of a reduction kernel: `groups` threadgroups per output, each writing its
+  // partial value to `c[output * groups + group]`.
+  void encode_reduce(id<MTLComputeCommandEncoder> enc,
+                     std::string const &kernel,
+                     id<MTLBuffer> a,
+                     id<MTLBuffer> c,
+                     size_t const count,
+                     size_t const outer_stride,
+                     size_t const inner_stride,
+                     uint32_t const groups,
+                     size_t const outputs)
+  {
+    [enc setComputePipelineState:this->ps.at(kernel)];
+    [enc setBuffer:a offset:0 atIndex:0];
+    [enc setBuffer:c offset:0 atIndex:1];
+    [enc setBytes:&count length:sizeof(count) atIndex:2];
+    [enc setBytes:&outer_stride length:sizeof(outer_stride) atIndex:3];
+    [enc setBytes:&inner_stride length:sizeof(inner_stride) atIndex:4];
+    [enc setBytes:&groups length:sizeof(groups) atIndex:5];
+
+    MTLSize const tgCount = MTLSizeMake(groups, outputs, 1);
+    MTLSize const tgSize  = MTLSizeMake(reduce_tg_size, 1, 1);
+
+    [enc dispatchThreadgroups:tgCount threadsPerThreadgroup:tgSize];
+  }
+
+  // Scratch for the partial values of a two-pass reduction, released once the command buffer
+  // that uses it has been committed: the command buffer keeps it alive until it completes.
+  id<MTLBuffer> new_partials(size_t const size)
+  {
+    id<MTLBuffer> partials = [this->device newBufferWithLength:size * sizeof(float)
+                                                       options:MTLResourceStorageModePrivate];
+    assert(partials != nil);
+    return partials;
+  }
+
+  // Walks `count` inputs spaced `inner_stride` apart per output, starting `outer_stride` after
+  // the previous output. Long reductions spread over several threadgroups per output, whose
+  // partial values the same kernel combines in a second pass: sums of sums, maxima of maxima and
+  // norms of norms are all the reduction of the whole.
+  void reduce_op(Buffer const &a, Buffer &c, Axis const axis, std::string const &kernel)
+  {
+    @autoreleasepool
+    {
+      assert_compatible_reduce(a, c, axis);
+
+      auto const *mtl_a = static_cast<MetalBuffer const *>(a.get());
+      auto *mtl_c       = static_cast<MetalBuffer *>(c.get());
+
+      auto const [rows, cols] = a.shape();
+
+      size_t count{0};
+      size_t outer_stride{0};
+      size_t inner_stride{1};
+      switch (axis)
+      {
+      case Axis::ROWS:
+        count        = cols;
+        outer_stride = cols;
+        break;
+      case Axis::COLS:
+        count        = rows;
+        outer_stride = 1;
+        inner_stride = cols;
+        break;
+      case Axis::ALL:
+        count = a.size();
+        break;
+      }
+
+      size_t const outputs  = c.size();
+      uint32_t const groups = reduce_groups(count, outputs);
+
+      id<MTLCommandBuffer> cmd = [this->queue commandBuffer];
+      [cmd retain];
+
+      // Dispatches on one encoder run in order, so the second pass sees all partial values.
+      id<MTLComputeCommandEncoder> enc = [cmd computeCommandEncoder];
+
+      id<MTLBuffer> partials = nil;
+      if (groups == 1)
+      {
+        this->encode_reduce(
+            enc, kernel, mtl_a->buffer, mtl_c->buffer, count, outer_stride, inner_stride, 1, outputs
+        );
+      }
+      else
+      {
+        partials = this->new_partials(outputs * groups);
+        this->encode_reduce(
+            enc, kernel, mtl_a->buffer, partials, count, outer_stride, inner_stride, groups, outputs
+        );
+        this->encode_reduce(enc, kernel, partials, mtl_c->buffer, groups, groups, 1, 1, outputs);
+      }
+
+      [enc endEncoding];
+      [cmd commit];
+
+      if (partials != nil)
+      {
+        [partials release];
+      }
+
+      cmd_swap(mtl_c->last_cmd, cmd);
+    }
+  }
+};
+      size_t outer_stride{0};
+      size_t inner_stride{1};
+      switch (axis)
+      {
+      case Axis::ROWS:
+        count        = cols;
+        outer_stride = cols;
+        break;
+      case Axis::COLS:
+        count        = rows;
+        outer_stride = 1;
+        inner_stride = cols;
+        break;
+      case Axis::ALL:
+        count = a.size();
+        break;
+      }
+
+      id<MTLCommandBuffer> cmd = [this->queue commandBuffer];
+      [cmd retain];
+
+      id<MTLComputeCommandEncoder> enc = [cmd computeCommandEncoder];
+
+      [enc setComputePipelineState:this->ps.at(kernel)];
+      [enc setBuffer:mtl_a->buffer offset:0 atIndex:0];
+      [enc setBuffer:mtl_c->buffer offset:0 atIndex:1];
+      [enc setBytes:&count length:sizeof(count) atIndex:2];
+      [enc setBytes:&outer_stride length:sizeof(outer_stride) atIndex:3];
+      [enc setBytes:&inner_stride length:sizeof(inner_stride) atIndex:4];
+
+      NSUInteger const n = c.size();
+
+      MTLSize const gridSize = MTLSizeMake(n, 1, 1);
+      NSUInteger const tgSize =
+          std::min<NSUInteger>(this->ps.at(kernel).maxTotalThreadsPerThreadgroup, n);
 
       MTLSize const threadgroupSize = MTLSizeMake(tgSize, 1, 1);
 
@@ -213,7 +473,7 @@ void MetalDevice::mul(Buffer const &a, Buffer const &b, Buffer &c) const
 
     id<MTLComputeCommandEncoder> enc = [cmd computeCommandEncoder];
 
-    [enc setComputePipelineState:this->pimpl->ps["mat_mul"]];
+    [enc setComputePipelineState:this->pimpl->ps.at("mat_mul")];
     [enc setBuffer:mtl_a->buffer offset:0 atIndex:0];
     [enc setBuffer:mtl_b->buffer offset:0 atIndex:1];
     [enc setBuffer:mtl_c->buffer offset:0 atIndex:2];
@@ -264,6 +524,192 @@ void MetalDevice::sdiv(Buffer const &a, Buffer const &b, Buffer &c) const
   this->pimpl->cwises_op(a, b, c, "mat_sdiv");
 }
 
+void MetalDevice::axpy(Buffer const &alpha, Buffer const &x, Buffer &y) const
+{
+  @autoreleasepool
+  {
+    assert_compatible_axpy(alpha, x, y);
+
+    auto const *mtl_alpha = static_cast<MetalBuffer const *>(alpha.get());
+    auto const *mtl_x     = static_cast<MetalBuffer const *>(x.get());
+    auto *mtl_y           = static_cast<MetalBuffer *>(y.get());
+
+    id<MTLCommandBuffer> cmd = [this->pimpl->queue commandBuffer];
+    [cmd retain];
+
+    id<MTLComputeCommandEncoder> enc = [cmd computeCommandEncoder];
+
+    [enc setComputePipelineState:this->pimpl->ps.at("mat_axpy")];
+    [enc setBuffer:mtl_alpha->buffer offset:0 atIndex:0];
+    [enc setBuffer:mtl_x->buffer offset:0 atIndex:1];
+    [enc setBuffer:mtl_y->buffer offset:0 atIndex:2];
+
+    NSUInteger const n = y.size();
+
+    MTLSize const gridSize = MTLSizeMake(n, 1, 1);
+    NSUInteger const tgSize =
+        std::min<NSUInteger>(this->pimpl->ps.at("mat_axpy").maxTotalThreadsPerThreadgroup, n);
+
+    MTLSize const threadgroupSize = MTLSizeMake(tgSize, 1, 1);
+
+    [enc dispatchThreads:gridSize threadsPerThreadgroup:threadgroupSize];
+
+    [enc endEncoding];
+    [cmd commit];
+
+    cmd_swap(mtl_y->last_cmd, cmd);
+  }
+}
+
+void MetalDevice::axpby(Buffer const &alpha, Buffer const &x, Buffer const &beta, Buffer &y) const
+{
+  @autoreleasepool
+  {
+    assert_compatible_axpy(alpha, x, y);
+    assert_compatible_axpy(beta, x, y);
+
+    auto const *mtl_alpha = static_cast<MetalBuffer const *>(alpha.get());
+    auto const *mtl_x     = static_cast<MetalBuffer const *>(x.get());
+    auto const *mtl_beta  = static_cast<MetalBuffer const *>(beta.get());
+    auto *mtl_y           = static_cast<MetalBuffer *>(y.get());
+
+    id<MTLCommandBuffer> cmd = [this->pimpl->queue commandBuffer];
+    [cmd retain];
+
+    id<MTLComputeCommandEncoder> enc = [cmd computeCommandEncoder];
+
+    [enc setComputePipelineState:this->pimpl->ps.at("mat_axpby")];
+    [enc setBuffer:mtl_alpha->buffer offset:0 atIndex:0];
+    [enc setBuffer:mtl_x->buffer offset:0 atIndex:1];
+    [enc setBuffer:mtl_beta->buffer offset:0 atIndex:2];
+    [enc setBuffer:mtl_y->buffer offset:0 atIndex:3];
+
+    NSUInteger const n = y.size();
+
+    MTLSize const gridSize = MTLSizeMake(n, 1, 1);
+    NSUInteger const tgSize =
+        std::min<NSUInteger>(this->pimpl->ps.at("mat_axpby").maxTotalThreadsPerThreadgroup, n);
+
+    MTLSize const threadgroupSize = MTLSizeMake(tgSize, 1, 1);
+
+    [enc dispatchThreads:gridSize threadsPerThreadgroup:threadgroupSize];
+
+    [enc endEncoding];
+    [cmd commit];
+
+    cmd_swap(mtl_y->last_cmd, cmd);
+  }
+}
+
+void MetalDevice::dot(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  @autoreleasepool
+  {
+    assert_compatible_dot(a, b, c);
+
+    auto const *mtl_a = static_cast<MetalBuffer const *>(a.get());
+    auto const *mtl_b = static_cast<MetalBuffer const *>(b.get());
+    auto *mtl_c       = static_cast<MetalBuffer *>(c.get());
+
+    size_t const n        = a.size();
+    uint32_t const groups = reduce_groups(n, 1);
+
+    id<MTLCommandBuffer> cmd = [this->pimpl->queue commandBuffer];
+    [cmd retain];
+
+    id<MTLComputeCommandEncoder> enc = [cmd computeCommandEncoder];
+
+    // Each threadgroup writes one partial sum, which mat_sum adds up in a second pass.
+    id<MTLBuffer> partials = groups == 1 ? mtl_c->buffer : this->pimpl->new_partials(groups);
+
+    [enc setComputePipelineState:this->pimpl->ps.at("mat_dot")];
+    [enc setBuffer:mtl_a->buffer offset:0 atIndex:0];
+    [enc setBuffer:mtl_b->buffer offset:0 atIndex:1];
+    [enc setBuffer:partials offset:0 atIndex:2];
+    [enc setBytes:&n length:sizeof(n) atIndex:3];
+    [enc setBytes:&groups length:sizeof(groups) atIndex:4];
+
+    MTLSize const tgCount = MTLSizeMake(groups, 1, 1);
+    MTLSize const tgSize  = MTLSizeMake(reduce_tg_size, 1, 1);
+
+    [enc dispatchThreadgroups:tgCount threadsPerThreadgroup:tgSize];
+
+    if (groups > 1)
+    {
+      this->pimpl->encode_reduce(enc, "mat_sum", partials, mtl_c->buffer, groups, groups, 1, 1, 1);
+    }
+
+    [enc endEncoding];
+    [cmd commit];
+
+    if (groups > 1)
+    {
+      [partials release];
+    }
+
+    cmd_swap(mtl_c->last_cmd, cmd);
+  }
+}
+
+void MetalDevice::sum(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->pimpl->reduce_op(a, c, axis, "mat_sum");
+}
+
+void MetalDevice::max(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->pimpl->reduce_op(a, c, axis, "mat_max");
+}
+
+void MetalDevice::min(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->pimpl->reduce_op(a, c, axis, "mat_min");
+}
+
+void MetalDevice::norm2(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  this->pimpl->reduce_op(a, c, axis, "mat_norm2");
+}
+
+void MetalDevice::eval(ExprProgram const &program, Buffer &out) const
+{
+  @autoreleasepool
+  {
+    assert_compatible_eval(program, out);
+
+    auto *mtl_out = static_cast<MetalBuffer *>(out.get());
+
+    id<MTLComputePipelineState> pipeline = this->pimpl->fused_pipeline(program);
+
+    id<MTLCommandBuffer> cmd = [this->pimpl->queue commandBuffer];
+    [cmd retain];
+
+    id<MTLComputeCommandEncoder> enc = [cmd computeCommandEncoder];
+
+    [enc setComputePipelineState:pipeline];
+    for (size_t i{0}; i < program.operands.size(); i++)
+    {
+      auto const *mtl_in = static_cast<MetalBuffer const *>(program.operands[i]->get());
+      [enc setBuffer:mtl_in->buffer offset:0 atIndex:i];
+    }
+    [enc setBuffer:mtl_out->buffer offset:0 atIndex:program.operands.size()];
+
+    NSUInteger const n = out.size();
+
+    MTLSize const gridSize  = MTLSizeMake(n, 1, 1);
+    NSUInteger const tgSize = std::min<NSUInteger>(pipeline.maxTotalThreadsPerThreadgroup, n);
+
+    MTLSize const threadgroupSize = MTLSizeMake(tgSize, 1, 1);
+
+    [enc dispatchThreads:gridSize threadsPerThreadgroup:threadgroupSize];
+
+    [enc endEncoding];
+    [cmd commit];
+
+    cmd_swap(mtl_out->last_cmd, cmd);
+  }
+}
+
 Buffer MetalDevice::new_buffer(std::vector<float> data, Shape shape) const
 {
   assert(this->pimpl->device != nil);
@@ -281,6 +727,7 @@ Buffer MetalDevice::new_buffer(std::vector<float> data, Shape shape) const
             auto *buf = static_cast<MetalBuffer *>(ptr);
             [buf->last_cmd release];
             [buf->buffer release];
+            delete buf;
           }
       },
       shape,
@@ -288,6 +735,66 @@ Buffer MetalDevice::new_buffer(std::vector<float> data, Shape shape) const
   };
 }
 
+Buffer MetalDevice::new_buffer_uninitialized(Shape shape) const
+{
+  assert(this->pimpl->device != nil);
+
+  NSUInteger const length = shape.rows * shape.cols * sizeof(float);
+
+  MetalBuffer mtl_buffer{};
+  mtl_buffer.buffer = [this->pimpl->device newBufferWithLength:length
+                                                       options:MTLResourceStorageModeShared];
+
+  return Buffer{
+      HandlePtr{
+          new MetalBuffer(mtl_buffer),
+          [](void *ptr) -> void
+          {
+            auto *buf = static_cast<MetalBuffer *>(ptr);
+            [buf->last_cmd release];
+            [buf->buffer release];
+            delete buf;
+          }
+      },
+      shape,
+      MetalDevice::s_type
+  };
+}
+
+void MetalDevice::fill(Buffer &buffer, float const value) const
+{
+  @autoreleasepool
+  {
+    assert_compatible_fill(buffer);
+
+    auto *mtl_buffer = static_cast<MetalBuffer *>(buffer.get());
+
+    id<MTLCommandBuffer> cmd = [this->pimpl->queue commandBuffer];
+    [cmd retain];
+
+    id<MTLComputeCommandEncoder> enc = [cmd computeCommandEncoder];
+
+    [enc setComputePipelineState:this->pimpl->ps.at("mat_fill")];
+    [enc setBuffer:mtl_buffer->buffer offset:0 atIndex:0];
+    [enc setBytes:&value length:sizeof(float) atIndex:1];
+
+    NSUInteger const n = buffer.size();
+
+    MTLSize const gridSize = MTLSizeMake(n, 1, 1);
+    NSUInteger const tgSize =
+        std::min<NSUInteger>(this->pimpl->ps.at("mat_fill").maxTotalThreadsPerThreadgroup, n);
+
+    MTLSize const threadgroupSize = MTLSizeMake(tgSize, 1, 1);
+
+    [enc dispatchThreads:gridSize threadsPerThreadgroup:threadgroupSize];
+
+    [enc endEncoding];
+    [cmd commit];
+
+    cmd_swap(mtl_buffer->last_cmd, cmd);
+  }
+}
+
 void MetalDevice::copy_buffer(Buffer const &from, Buffer &to) const
 {
   @autoreleasepool
@@ -331,7 +838,7 @@ void MetalDevice::transpose(Buffer const &from, Buffer &to) const
 
     id<MTLComputeCommandEncoder> enc = [cmd computeCommandEncoder];
 
-    [enc setComputePipelineState:this->pimpl->ps["mat_trans"]];
+    [enc setComputePipelineState:this->pimpl->ps.at("mat_trans")];
     [enc setBuffer:mtl_from->buffer offset:0 atIndex:0];
     [enc setBuffer:mtl_to->buffer offset:0 atIndex:1];
     [enc setBytes:&m length:sizeof(m) atIndex:2];
@@ -362,6 +869,16 @@ std::vector<float> MetalDevice::cpu(Buffer const &buffer) const
   return result;
 }
 
+float const *MetalDevice::host_data(Buffer const &buffer) const
+{
+  auto const *mtl_buf = static_cast<MetalBuffer const *>(buffer.get());
+
+  // Buffers use shared storage, so their contents are directly readable once the GPU is done.
+  cmd_wait_release(mtl_buf->last_cmd);
+
+  return static_cast<float const *>(mtl_buf->buffer.contents);
+}
+
 void MetalDevice::sync(Buffer const &buffer) const
 {
   auto const *mtl_buf = static_cast<MetalBuffer const *>(buffer.get());
@@ -0,0 +1,12 @@
+#include <metal_stdlib>
+
+using namespace metal;
+
+kernel void mat_axpby(const device float* alpha,
+                      const device float* x,
+                      const device float* beta,
+                      device float* y,
+                      uint id [[thread_position_in_grid]])
+{
+    y[id] = fma(alpha[0], x[id], beta[0] * y[id]);
+}
@@ -0,0 +1,11 @@
+#include <metal_stdlib>
+
+using namespace metal;
+
+kernel void mat_axpy(const device float* alpha,
+                     const device float* x,
+                     device float* y,
+                     uint id [[thread_position_in_grid]])
+{
+    y[id] = fma(alpha[0], x[id], y[id]);
+}
@@ -0,0 +1,44 @@
+#include <metal_stdlib>
+
+using namespace metal;
+
+// Launched as `groups` threadgroups of `tg_size` threads: every thread accumulates a strided
+// slice, then each group combines its threads with a tree in threadgroup memory and writes its
+// partial sum to `c[group]`. With several groups, mat_sum adds the partial sums in a second pass.
+kernel void mat_dot(
+    const device float* a,
+    const device float* b,
+    device float* c,
+    constant size_t& n,
+    constant uint& groups,
+    uint group [[threadgroup_position_in_grid]],
+    uint id [[thread_position_in_threadgroup]]
+)
+{
+    // Must match `reduce_tg_size` in metal_device.mm.
+    constexpr uint tg_size = 256;
+    threadgroup float partial[tg_size];
+
+    float acc{0.0};
+    for (size_t i{(group * tg_size) + id}; i < n; i += groups * tg_size)
+    {
+      acc = fma(a[i], b[i], acc);
+    }
+
+    partial[id] = acc;
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+
+    for (uint stride{tg_size / 2}; stride > 0; stride /= 2)
+    {
+      if (id < stride)
+      {
+        partial[id] += partial[id + stride];
+      }
+      threadgroup_barrier(mem_flags::mem_threadgroup);
+    }
+
+    if (id == 0)
+    {
+      c[group] = partial[0];
+    }
+}
@@ -0,0 +1,10 @@
+#include <metal_stdlib>
+
+using namespace metal;
+
+kernel void mat_fill(device float* c,
+                     constant float& value,
+                     uint id [[thread_position_in_grid]])
+{
+    c[id] = value;
+}
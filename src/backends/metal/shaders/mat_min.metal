@@ -0,0 +1,47 @@
+#include <metal_stdlib>
+
+using namespace metal;
+
+// Same launch layout as mat_sum: one partial minimum per threadgroup, combined by a second pass.
+kernel void mat_min(
+    const device float* a,
+    device float* c,
+    constant size_t& count,
+    constant size_t& outer_stride,
+    constant size_t& inner_stride,
+    constant uint& groups,
+    uint2 group [[threadgroup_position_in_grid]],
+    uint id [[thread_position_in_threadgroup]]
+)
+{
+    // Must match `reduce_tg_size` in metal_device.mm.
+    constexpr uint tg_size = 256;
+    threadgroup float partial[tg_size];
+
+    size_t const base  = group.y * outer_stride;
+    size_t const begin = (group.x * tg_size) + id;
+    size_t const step  = groups * tg_size;
+
+    float acc{INFINITY};
+    for (size_t p{begin}; p < count; p += step)
+    {
+      acc = min(acc, a[base + p * inner_stride]);
+    }
+
+    partial[id] = acc;
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+
+    for (uint stride{tg_size / 2}; stride > 0; stride /= 2)
+    {
+      if (id < stride)
+      {
+        partial[id] = min(partial[id], partial[id + stride]);
+      }
+      threadgroup_barrier(mem_flags::mem_threadgroup);
+    }
+
+    if (id == 0)
+    {
+      c[(group.y * groups) + group.x] = partial[0];
+    }
+}
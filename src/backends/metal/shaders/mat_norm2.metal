@@ -0,0 +1,49 @@
+#include <metal_stdlib>
+
+using namespace metal;
+
+// Same launch layout as mat_sum. Each group writes the norm of its slice, and the norm of those
+// norms is the norm of the whole, so a second pass of this kernel combines them.
+kernel void mat_norm2(
+    const device float* a,
+    device float* c,
+    constant size_t& count,
+    constant size_t& outer_stride,
+    constant size_t& inner_stride,
+    constant uint& groups,
+    uint2 group [[threadgroup_position_in_grid]],
+    uint id [[thread_position_in_threadgroup]]
+)
+{
+    // Must match `reduce_tg_size` in metal_device.mm.
+    constexpr uint tg_size = 256;
+    threadgroup float partial[tg_size];
+
+    size_t const base  = group.y * outer_stride;
+    size_t const begin = (group.x * tg_size) + id;
+    size_t const step  = groups * tg_size;
+
+    float acc{0.0};
+    for (size_t p{begin}; p < count; p += step)
+    {
+      float const x = a[base + p * inner_stride];
+      acc           = fma(x, x, acc);
+    }
+
+    partial[id] = acc;
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+
+    for (uint stride{tg_size / 2}; stride > 0; stride /= 2)
+    {
+      if (id < stride)
+      {
+        partial[id] += partial[id + stride];
+      }
+      threadgroup_barrier(mem_flags::mem_threadgroup);
+    }
+
+    if (id == 0)
+    {
+      c[(group.y * groups) + group.x] = sqrt(partial[0]);
+    }
+}
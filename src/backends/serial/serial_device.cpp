@@ -1,12 +1,16 @@
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <limits>
 
+#include "expression_eval.hpp"
+#include "host_storage.hpp"
+#include "reproducible.hpp"
 #include "serial_device.hpp"
 
 namespace gpu_playground::backend
 {
 
-using SerialBuffer = std::vector<float>;
-
 namespace
 {
 
@@ -35,9 +39,9 @@ void cwisem_op(Buffer const &a, Buffer const &b, Buffer &c, Op const &op)
 {
   assert_same_shape(a, b, c);
 
-  auto const &serial_a = *static_cast<SerialBuffer const *>(a.get());
-  auto const &serial_b = *static_cast<SerialBuffer const *>(b.get());
-  auto &serial_c       = *static_cast<SerialBuffer *>(c.get());
+  auto const *serial_a = host_ptr(a);
+  auto const *serial_b = host_ptr(b);
+  auto *serial_c       = host_ptr(c);
 
   for (size_t i{0}; i < a.size(); i++)
   {
@@ -50,17 +54,203 @@ void cwises_op(Buffer const &a, Buffer const &b, Buffer &c, Op const &op)
 {
   assert_compatible_sop(a, b, c);
 
-  auto const &serial_a = *static_cast<SerialBuffer const *>(a.get());
-  auto const &serial_b = *static_cast<SerialBuffer const *>(b.get());
-  auto &serial_c       = *static_cast<SerialBuffer *>(c.get());
+  auto const *serial_a = host_ptr(a);
+  auto const *serial_b = host_ptr(b);
+  auto *serial_c       = host_ptr(c);
 
-  auto const scalar_b = serial_b.front();
+  auto const scalar_b = serial_b[0];
   for (size_t i{0}; i < a.size(); i++)
   {
     serial_c[i] = op(serial_a[i], scalar_b);
   }
 }
 
+struct Sum
+{
+  [[nodiscard]] static constexpr float init() { return 0.0F; }
+
+  [[nodiscard]] constexpr float operator()(float const acc, float const x) const { return acc + x; }
+
+  [[nodiscard]] constexpr float combine(float const a, float const b) const { return a + b; }
+
+  [[nodiscard]] constexpr float finalize(float const acc) const { return acc; }
+};
+
+struct Max
+{
+  [[nodiscard]] static constexpr float init() { return -std::numeric_limits<float>::infinity(); }
+
+  [[nodiscard]] constexpr float operator()(float const acc, float const x) const
+  {
+    return std::max(acc, x);
+  }
+
+  [[nodiscard]] constexpr float combine(float const a, float const b) const
+  {
+    return std::max(a, b);
+  }
+
+  [[nodiscard]] constexpr float finalize(float const acc) const { return acc; }
+};
+
+struct Min
+{
+  [[nodiscard]] static constexpr float init() { return std::numeric_limits<float>::infinity(); }
+
+  [[nodiscard]] constexpr float operator()(float const acc, float const x) const
+  {
+    return std::min(acc, x);
+  }
+
+  [[nodiscard]] constexpr float combine(float const a, float const b) const
+  {
+    return std::min(a, b);
+  }
+
+  [[nodiscard]] constexpr float finalize(float const acc) const { return acc; }
+};
+
+struct Norm2
+{
+  [[nodiscard]] static constexpr float init() { return 0.0F; }
+
+  [[nodiscard]] float operator()(float const acc, float const x) const
+  {
+    return std::fma(x, x, acc);
+  }
+
+  [[nodiscard]] constexpr float combine(float const a, float const b) const { return a + b; }
+
+  [[nodiscard]] float finalize(float const acc) const { return std::sqrt(acc); }
+};
+
+// Independent accumulators break the loop-carried dependency so that the compiler can keep
+// several additions in flight (and vectorise them) instead of waiting on a single register.
+constexpr size_t n_acc{4};
+
+template <class Op>
+float reduce_contiguous(float const *data, size_t const size, Op const &op)
+{
+  std::array<float, n_acc> acc{};
+  acc.fill(Op::init());
+
+  size_t const unrolled = size - (size % n_acc);
+  for (size_t i{0}; i < unrolled; i += n_acc)
+  {
+    for (size_t l{0}; l < n_acc; l++)
+    {
+      acc[l] = op(acc[l], data[i + l]);
+    }
+  }
+  for (size_t i{unrolled}; i < size; i++)
+  {
+    acc[0] = op(acc[0], data[i]);
+  }
+
+  float res = acc.front();
+  for (size_t l{1}; l < n_acc; l++)
+  {
+    res = op.combine(res, acc[l]);
+  }
+
+  return res;
+}
+
+template <class Op>
+void reduce_op(Buffer const &a, Buffer &c, Axis const axis, Op const &op)
+{
+  assert_compatible_reduce(a, c, axis);
+
+  auto const *serial_a = host_ptr(a);
+  auto *serial_c       = host_ptr(c);
+
+  auto const [rows, cols] = a.shape();
+
+  switch (axis)
+  {
+  case Axis::ROWS:
+    for (size_t i{0}; i < rows; i++)
+    {
+      serial_c[i] = op.finalize(reduce_contiguous(&serial_a[i * cols], cols, op));
+    }
+    break;
+  case Axis::COLS:
+    // Walk the rows in memory order, every column is its own accumulator.
+    std::fill_n(serial_c, cols, Op::init());
+    for (size_t i{0}; i < rows; i++)
+    {
+      for (size_t j{0}; j < cols; j++)
+      {
+        serial_c[j] = op(serial_c[j], serial_a[(i * cols) + j]);
+      }
+    }
+    for (size_t j{0}; j < cols; j++)
+    {
+      serial_c[j] = op.finalize(serial_c[j]);
+    }
+    break;
+  case Axis::ALL:
+    serial_c[0] = op.finalize(reduce_contiguous(serial_a, a.size(), op));
+    break;
+  }
+}
+
+template <class Op>
+void eval_block_op(
+    EvalSlot const &lhs, EvalSlot const &rhs, float *dst, size_t const len, Op const &op
+)
+{
+  if (lhs.data != nullptr and rhs.data != nullptr)
+  {
+    for (size_t i{0}; i < len; i++)
+    {
+      dst[i] = op(lhs.data[i], rhs.data[i]);
+    }
+  }
+  else if (lhs.data != nullptr)
+  {
+    for (size_t i{0}; i < len; i++)
+    {
+      dst[i] = op(lhs.data[i], rhs.scalar);
+    }
+  }
+  else if (rhs.data != nullptr)
+  {
+    for (size_t i{0}; i < len; i++)
+    {
+      dst[i] = op(lhs.scalar, rhs.data[i]);
+    }
+  }
+  else
+  {
+    std::fill_n(dst, len, op(lhs.scalar, rhs.scalar));
+  }
+}
+
+void eval_block_op(
+    ExprOp const op, EvalSlot const &lhs, EvalSlot const &rhs, float *dst, size_t const len
+)
+{
+  switch (op)
+  {
+  case ExprOp::ADD:
+    eval_block_op(lhs, rhs, dst, len, Add{});
+    break;
+  case ExprOp::SUB:
+    eval_block_op(lhs, rhs, dst, len, Sub{});
+    break;
+  case ExprOp::MUL:
+    eval_block_op(lhs, rhs, dst, len, Mul{});
+    break;
+  case ExprOp::DIV:
+    eval_block_op(lhs, rhs, dst, len, Div{});
+    break;
+  case ExprOp::LOAD:
+  case ExprOp::LOAD_SCALAR:
+    break;
+  }
+}
+
 } // namespace
 
 void SerialDevice::add(Buffer const &a, Buffer const &b, Buffer &c) const
@@ -77,13 +267,16 @@ void SerialDevice::mul(Buffer const &a, Buffer const &b, Buffer &c) const
 {
   assert_compatible_mul(a, b, c);
 
-  auto const &serial_a = *static_cast<SerialBuffer const *>(a.get());
-  auto const &serial_b = *static_cast<SerialBuffer const *>(b.get());
-  auto &serial_c       = *static_cast<SerialBuffer *>(c.get());
+  auto const *serial_a = host_ptr(a);
+  auto const *serial_b = host_ptr(b);
+  auto *serial_c       = host_ptr(c);
 
   auto const [m, k] = a.shape();
   auto const n      = b.shape().cols;
 
+  // The loops accumulate into c, which may hold stale values from a reused buffer.
+  std::fill_n(serial_c, c.size(), 0.0F);
+
   for (size_t i{0}; i < m; i++)
   {
     for (size_t p{0}; p < k; p++)
@@ -128,34 +321,169 @@ void SerialDevice::sdiv(Buffer const &a, Buffer const &b, Buffer &c) const
   cwises_op(a, b, c, Div{});
 }
 
+void SerialDevice::axpy(Buffer const &alpha, Buffer const &x, Buffer &y) const
+{
+  assert_compatible_axpy(alpha, x, y);
+
+  auto const *serial_alpha = host_ptr(alpha);
+  auto const *serial_x     = host_ptr(x);
+  auto *serial_y           = host_ptr(y);
+
+  auto const scalar_alpha = serial_alpha[0];
+  for (size_t i{0}; i < y.size(); i++)
+  {
+    serial_y[i] = std::fma(scalar_alpha, serial_x[i], serial_y[i]);
+  }
+}
+
+void SerialDevice::axpby(Buffer const &alpha, Buffer const &x, Buffer const &beta, Buffer &y) const
+{
+  assert_compatible_axpy(alpha, x, y);
+  assert_compatible_axpy(beta, x, y);
+
+  auto const *serial_alpha = host_ptr(alpha);
+  auto const *serial_x     = host_ptr(x);
+  auto const *serial_beta  = host_ptr(beta);
+  auto *serial_y           = host_ptr(y);
+
+  auto const scalar_alpha = serial_alpha[0];
+  auto const scalar_beta  = serial_beta[0];
+  for (size_t i{0}; i < y.size(); i++)
+  {
+    serial_y[i] = std::fma(scalar_alpha, serial_x[i], scalar_beta * serial_y[i]);
+  }
+}
+
+void SerialDevice::dot(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::dot(a, b, c);
+    return;
+  }
+
+  assert_compatible_dot(a, b, c);
+
+  auto const *serial_a = host_ptr(a);
+  auto const *serial_b = host_ptr(b);
+  auto *serial_c       = host_ptr(c);
+
+  std::array<float, n_acc> acc{};
+
+  size_t const size     = a.size();
+  size_t const unrolled = size - (size % n_acc);
+  for (size_t i{0}; i < unrolled; i += n_acc)
+  {
+    for (size_t l{0}; l < n_acc; l++)
+    {
+      acc[l] = std::fma(serial_a[i + l], serial_b[i + l], acc[l]);
+    }
+  }
+  for (size_t i{unrolled}; i < size; i++)
+  {
+    acc[0] = std::fma(serial_a[i], serial_b[i], acc[0]);
+  }
+
+  serial_c[0] = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+void SerialDevice::sum(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Sum>(a, c, axis);
+    return;
+  }
+
+  reduce_op(a, c, axis, Sum{});
+}
+
+void SerialDevice::max(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Max>(a, c, axis);
+    return;
+  }
+
+  reduce_op(a, c, axis, Max{});
+}
+
+void SerialDevice::min(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Min>(a, c, axis);
+    return;
+  }
+
+  reduce_op(a, c, axis, Min{});
+}
+
+void SerialDevice::norm2(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Norm2>(a, c, axis);
+    return;
+  }
+
+  reduce_op(a, c, axis, Norm2{});
+}
+
+void SerialDevice::eval(ExprProgram const &program, Buffer &out) const
+{
+  assert_compatible_eval(program, out);
+
+  auto const operands = host_operands(program);
+  eval_program(
+      program,
+      operands,
+      host_ptr(out),
+      0,
+      out.size(),
+      [](ExprOp const op, EvalSlot const &lhs, EvalSlot const &rhs, float *dst, size_t const len)
+      { eval_block_op(op, lhs, rhs, dst, len); }
+  );
+}
+
 Buffer SerialDevice::new_buffer(std::vector<float> data, Shape shape) const
 {
-  return Buffer{
-      HandlePtr{
-          new SerialBuffer(std::move(data)),
-          [](void *ptr) -> void { delete static_cast<SerialBuffer *>(ptr); }
-      },
-      shape,
-      SerialDevice::s_type
-  };
+  auto buffer = this->new_buffer_uninitialized(shape);
+  std::copy(data.begin(), data.end(), host_ptr(buffer));
+  return buffer;
+}
+
+Buffer SerialDevice::new_buffer_uninitialized(Shape shape) const
+{
+  return Buffer{new_host_storage(shape.rows * shape.cols), shape, SerialDevice::s_type};
+}
+
+void SerialDevice::fill(Buffer &buffer, float const value) const
+{
+  assert_compatible_fill(buffer);
+
+  auto *serial_buffer = host_ptr(buffer);
+
+  std::fill_n(serial_buffer, buffer.size(), value);
 }
 
 void SerialDevice::copy_buffer(Buffer const &from, Buffer &to) const
 {
   assert_compatible_copy(from, to);
 
-  auto const &serial_from = *static_cast<SerialBuffer const *>(from.get());
-  auto &serial_to         = *static_cast<SerialBuffer *>(to.get());
+  auto const *serial_from = host_ptr(from);
+  auto *serial_to         = host_ptr(to);
 
-  serial_to = serial_from;
+  std::copy_n(serial_from, from.size(), serial_to);
 }
 
 void SerialDevice::transpose(Buffer const &from, Buffer &to) const
 {
   assert_compatible_transpose(from, to);
 
-  auto const &serial_from = *static_cast<SerialBuffer const *>(from.get());
-  auto &serial_to         = *static_cast<SerialBuffer *>(to.get());
+  auto const *serial_from = host_ptr(from);
+  auto *serial_to         = host_ptr(to);
 
   auto const [rows, cols] = from.shape();
   for (size_t i{0}; i < rows; i++)
@@ -169,7 +497,13 @@ void SerialDevice::transpose(Buffer const &from, Buffer &to) const
 
 std::vector<float> SerialDevice::cpu(Buffer const &buffer) const
 {
-  return *static_cast<SerialBuffer const *>(buffer.get());
+  auto const *serial_buffer = host_ptr(buffer);
+  return {serial_buffer, serial_buffer + buffer.size()};
+}
+
+float const *SerialDevice::host_data(Buffer const &buffer) const
+{
+  return host_ptr(buffer);
 }
 
 void SerialDevice::sync([[maybe_unused]] Buffer const &buffer) const {}
@@ -1,111 +1,57 @@
-#include <cmath>
-
-#include "xsimd/xsimd.hpp"
+#include <algorithm>
+#include <vector>
 
+#include "host_storage.hpp"
+#include "reproducible.hpp"
 #include "simd_device.hpp"
+#include "simd_kernels.hpp"
 
 namespace gpu_playground::backend
 {
 
-using SIMDBuffer = std::vector<float, xsimd::aligned_allocator<float>>;
-
 namespace
 {
 
-struct Add
-{
-  [[nodiscard]] xsimd::batch<float>
-  operator()(xsimd::batch<float> const a, xsimd::batch<float> const b) const
-  {
-    return a + b;
-  }
-
-  [[nodiscard]] constexpr float operator()(float const a, float const b) const { return a + b; }
-};
-
-struct Sub
-{
-  [[nodiscard]] xsimd::batch<float>
-  operator()(xsimd::batch<float> const a, xsimd::batch<float> const b) const
-  {
-    return a - b;
-  }
-
-  [[nodiscard]] constexpr float operator()(float const a, float const b) const { return a - b; }
-};
-
-struct Mul
-{
-  [[nodiscard]] xsimd::batch<float>
-  operator()(xsimd::batch<float> const a, xsimd::batch<float> const b) const
-  {
-    return a * b;
-  }
-
-  [[nodiscard]] constexpr float operator()(float const a, float const b) const { return a * b; }
-};
-
-struct Div
-{
-  [[nodiscard]] xsimd::batch<float>
-  operator()(xsimd::batch<float> const a, xsimd::batch<float> const b) const
-  {
-    return a / b;
-  }
-
-  [[nodiscard]] constexpr float operator()(float const a, float const b) const { return a / b; }
-};
-
 template <class Op>
 void cwisem_op(Buffer const &a, Buffer const &b, Buffer &c, Op const &op)
 {
   assert_same_shape(a, b, c);
-
-  auto const &simd_a = *static_cast<SIMDBuffer const *>(a.get());
-  auto const &simd_b = *static_cast<SIMDBuffer const *>(b.get());
-  auto &simd_c       = *static_cast<SIMDBuffer *>(c.get());
-
-  size_t const size          = a.size();
-  constexpr size_t simd_size = xsimd::simd_type<float>::size;
-  size_t const vec_size      = size - (size % simd_size);
-
-  for (size_t i{0}; i < vec_size; i += simd_size)
-  {
-    auto const ba   = xsimd::load_aligned(&simd_a[i]);
-    auto const bb   = xsimd::load_aligned(&simd_b[i]);
-    auto const bres = op(ba, bb);
-    bres.store_aligned(&simd_c[i]);
-  }
-  for (size_t i{vec_size}; i < size; i++)
-  {
-    simd_c[i] = op(simd_a[i], simd_b[i]);
-  }
+  simd::cwisem(host_ptr(a), host_ptr(b), host_ptr(c), a.size(), op);
 }
 
 template <class Op>
 void cwises_op(Buffer const &a, Buffer const &b, Buffer &c, Op const &op)
 {
   assert_compatible_sop(a, b, c);
+  simd::cwises(host_ptr(a), host_ptr(b)[0], host_ptr(c), a.size(), op);
+}
 
-  auto const &simd_a = *static_cast<SIMDBuffer const *>(a.get());
-  auto const &simd_b = *static_cast<SIMDBuffer const *>(b.get());
-  auto &simd_c       = *static_cast<SIMDBuffer *>(c.get());
+template <class Op>
+void reduce_op(Buffer const &a, Buffer &c, Axis const axis, Op const &op)
+{
+  assert_compatible_reduce(a, c, axis);
 
-  size_t const size          = a.size();
-  constexpr size_t simd_size = xsimd::simd_type<float>::size;
-  size_t const vec_size      = size - (size % simd_size);
+  auto const *simd_a = host_ptr(a);
+  auto *simd_c       = host_ptr(c);
 
-  auto const sb = simd_b.front();
-  auto const bb = xsimd::broadcast(sb);
-  for (size_t i{0}; i < vec_size; i += simd_size)
-  {
-    auto const ba   = xsimd::load_aligned(&simd_a[i]);
-    auto const bres = op(ba, bb);
-    bres.store_aligned(&simd_c[i]);
-  }
-  for (size_t i{vec_size}; i < size; i++)
+  auto const [rows, cols] = a.shape();
+
+  switch (axis)
   {
-    simd_c[i] = op(simd_a[i], sb);
+  case Axis::ROWS:
+    simd::reduce_rows(simd_a, simd_c, cols, 0, rows, op);
+    break;
+  case Axis::COLS:
+    std::fill_n(simd_c, cols, Op::init());
+    simd::accumulate_rows(simd_a, simd_c, cols, 0, rows, op);
+    for (size_t j{0}; j < cols; j++)
+    {
+      simd_c[j] = op.finalize(simd_c[j]);
+    }
+    break;
+  case Axis::ALL:
+    simd_c[0] = op.finalize(simd::reduce_contiguous(simd_a, a.size(), op));
+    break;
   }
 }
 
@@ -113,124 +59,174 @@ void cwises_op(Buffer const &a, Buffer const &b, Buffer &c, Op const &op)
 
 void SIMDDevice::add(Buffer const &a, Buffer const &b, Buffer &c) const
 {
-  cwisem_op(a, b, c, Add{});
+  cwisem_op(a, b, c, simd::Add{});
 }
 
 void SIMDDevice::sub(Buffer const &a, Buffer const &b, Buffer &c) const
 {
-  cwisem_op(a, b, c, Sub{});
+  cwisem_op(a, b, c, simd::Sub{});
 }
 
 void SIMDDevice::mul(Buffer const &a, Buffer const &b, Buffer &c) const
 {
   assert_compatible_mul(a, b, c);
 
-  auto const &simd_a = *static_cast<SIMDBuffer const *>(a.get());
-  auto const &simd_b = *static_cast<SIMDBuffer const *>(b.get());
-  auto &simd_c       = *static_cast<SIMDBuffer *>(c.get());
-
-  auto const [m, k]          = a.shape();
-  auto const n               = b.shape().cols;
-  constexpr size_t simd_size = xsimd::simd_type<float>::size;
-  size_t const n_simd        = n - (n % simd_size);
-
-  for (size_t i{0}; i < m; i++)
-  {
-    for (size_t p = 0; p < k; ++p)
-    {
-      auto const a_ip = xsimd::broadcast(simd_a[(i * k) + p]);
-
-      for (size_t j{0}; j < n_simd; j += simd_size)
-      {
-        auto c       = xsimd::load_aligned(&simd_c[(i * n) + j]);
-        auto const b = xsimd::load_aligned(&simd_b[(p * n) + j]);
-        c            = xsimd::fma(a_ip, b, c);
-        c.store_aligned(&simd_c[(i * n) + j]);
-      }
-
-      for (size_t j{n_simd}; j < n; j++)
-      {
-        simd_c[(i * n) + j] =
-            std::fma(simd_a[(i * k) + p], simd_b[(p * n) + j], simd_c[(i * n) + j]);
-      }
-    }
-  }
+  auto const [m, k] = a.shape();
+  auto const n      = b.shape().cols;
+  simd::gemm(host_ptr(a), k, host_ptr(b), n, host_ptr(c), n, m, n, k, true);
 }
 
 void SIMDDevice::cmul(Buffer const &a, Buffer const &b, Buffer &c) const
 {
-  cwisem_op(a, b, c, Mul{});
+  cwisem_op(a, b, c, simd::Mul{});
 }
 
 void SIMDDevice::cdiv(Buffer const &a, Buffer const &b, Buffer &c) const
 {
-  cwisem_op(a, b, c, Div{});
+  cwisem_op(a, b, c, simd::Div{});
 }
 
 void SIMDDevice::sadd(Buffer const &a, Buffer const &b, Buffer &c) const
 {
-  cwises_op(a, b, c, Add{});
+  cwises_op(a, b, c, simd::Add{});
 }
 
 void SIMDDevice::ssub(Buffer const &a, Buffer const &b, Buffer &c) const
 {
-  cwises_op(a, b, c, Sub{});
+  cwises_op(a, b, c, simd::Sub{});
 }
 
 void SIMDDevice::smul(Buffer const &a, Buffer const &b, Buffer &c) const
 {
-  cwises_op(a, b, c, Mul{});
+  cwises_op(a, b, c, simd::Mul{});
 }
 
 void SIMDDevice::sdiv(Buffer const &a, Buffer const &b, Buffer &c) const
 {
-  cwises_op(a, b, c, Div{});
+  cwises_op(a, b, c, simd::Div{});
+}
+
+void SIMDDevice::axpy(Buffer const &alpha, Buffer const &x, Buffer &y) const
+{
+  assert_compatible_axpy(alpha, x, y);
+  simd::axpy(host_ptr(alpha)[0], host_ptr(x), host_ptr(y), y.size());
+}
+
+void SIMDDevice::axpby(Buffer const &alpha, Buffer const &x, Buffer const &beta, Buffer &y) const
+{
+  assert_compatible_axpy(alpha, x, y);
+  assert_compatible_axpy(beta, x, y);
+  simd::axpby(host_ptr(alpha)[0], host_ptr(x), host_ptr(beta)[0], host_ptr(y), y.size());
+}
+
+void SIMDDevice::dot(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::dot(a, b, c);
+    return;
+  }
+
+  assert_compatible_dot(a, b, c);
+  host_ptr(c)[0] = simd::dot(host_ptr(a), host_ptr(b), a.size());
+}
+
+void SIMDDevice::sum(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Sum>(a, c, axis);
+    return;
+  }
+
+  reduce_op(a, c, axis, simd::Sum{});
+}
+
+void SIMDDevice::max(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Max>(a, c, axis);
+    return;
+  }
+
+  reduce_op(a, c, axis, simd::Max{});
+}
+
+void SIMDDevice::min(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Min>(a, c, axis);
+    return;
+  }
+
+  reduce_op(a, c, axis, simd::Min{});
+}
+
+void SIMDDevice::norm2(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Norm2>(a, c, axis);
+    return;
+  }
+
+  reduce_op(a, c, axis, simd::Norm2{});
+}
+
+void SIMDDevice::eval(ExprProgram const &program, Buffer &out) const
+{
+  assert_compatible_eval(program, out);
+
+  simd::eval(program, host_operands(program), host_ptr(out), 0, out.size());
 }
 
 Buffer SIMDDevice::new_buffer(std::vector<float> data, Shape shape) const
 {
-  auto const size = data.size();
-  return Buffer{
-      HandlePtr{
-          new SIMDBuffer(data.cbegin(), data.cend()),
-          [](void *ptr) -> void { delete static_cast<SIMDBuffer *>(ptr); }
-      },
-      shape,
-      SIMDDevice::s_type,
-  };
+  auto buffer = this->new_buffer_uninitialized(shape);
+  std::copy(data.cbegin(), data.cend(), host_ptr(buffer));
+  return buffer;
+}
+
+Buffer SIMDDevice::new_buffer_uninitialized(Shape shape) const
+{
+  return Buffer{new_host_storage(shape.rows * shape.cols), shape, SIMDDevice::s_type};
+}
+
+void SIMDDevice::fill(Buffer &buffer, float const value) const
+{
+  assert_compatible_fill(buffer);
+  simd::fill(host_ptr(buffer), buffer.size(), value);
 }
 
 void SIMDDevice::copy_buffer(Buffer const &from, Buffer &to) const
 {
   assert_compatible_copy(from, to);
 
-  auto const &simd_from = *static_cast<SIMDBuffer const *>(from.get());
-  auto &simd_to         = *static_cast<SIMDBuffer *>(to.get());
+  auto const *simd_from = host_ptr(from);
+  auto *simd_to         = host_ptr(to);
 
-  simd_to = simd_from;
+  std::copy_n(simd_from, from.size(), simd_to);
 }
 
 void SIMDDevice::transpose(Buffer const &from, Buffer &to) const
 {
   assert_compatible_transpose(from, to);
 
-  auto const &simd_from = *static_cast<SIMDBuffer const *>(from.get());
-  auto &simd_to         = *static_cast<SIMDBuffer *>(to.get());
-
   auto const [rows, cols] = from.shape();
-  for (size_t i{0}; i < rows; i++)
-  {
-    for (size_t j{0}; j < cols; j++)
-    {
-      simd_to[(j * rows) + i] = simd_from[(i * cols) + j];
-    }
-  }
+  simd::transpose(host_ptr(from), cols, host_ptr(to), rows, rows, cols);
 }
 
 std::vector<float> SIMDDevice::cpu(Buffer const &buffer) const
 {
-  auto simd_buffer = *static_cast<SIMDBuffer const *>(buffer.get());
-  return {simd_buffer.cbegin(), simd_buffer.cend()};
+  auto const *simd_buffer = host_ptr(buffer);
+  return {simd_buffer, simd_buffer + buffer.size()};
+}
+
+float const *SIMDDevice::host_data(Buffer const &buffer) const
+{
+  return host_ptr(buffer);
 }
 
 void SIMDDevice::sync(Buffer const &buffer) const {}
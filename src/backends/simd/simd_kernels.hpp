@@ -0,0 +1,611 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xsimd/xsimd.hpp"
+
+#include "expression_eval.hpp"
+#include "host_storage.hpp"
+
+// The SIMD kernels work on ranges of host memory rather than on buffers, so that the SIMD device
+// runs them over whole buffers and the threaded device over the chunk each worker owns.
+namespace gpu_playground::backend::simd
+{
+
+// Aligned like xsimd::aligned_allocator, but new elements are default-initialised, which leaves
+// floats uninitialised: allocating scratch space that is about to be overwritten does not zero it.
+template <class T>
+struct DefaultInitAllocator : xsimd::aligned_allocator<T>
+{
+  using xsimd::aligned_allocator<T>::aligned_allocator;
+
+  template <class U>
+  struct rebind
+  {
+    using other = DefaultInitAllocator<U>;
+  };
+
+  template <class U>
+  void construct(U *ptr) noexcept(std::is_nothrow_default_constructible_v<U>)
+  {
+    ::new (static_cast<void *>(ptr)) U;
+  }
+
+  template <class U, class... Args>
+  void construct(U *ptr, Args &&...args)
+  {
+    ::new (static_cast<void *>(ptr)) U(std::forward<Args>(args)...);
+  }
+};
+
+using AlignedVector = std::vector<float, DefaultInitAllocator<float>>;
+
+// Buffers live in the shared host storage, whose alignment must allow aligned batch loads.
+static_assert(
+    host_alignment % xsimd::default_arch::alignment() == 0,
+    "Host storage is not aligned for the SIMD instruction set"
+);
+
+inline constexpr size_t simd_size{xsimd::simd_type<float>::size};
+
+// Ranges passed to the element-wise kernels must start at a multiple of this many floats from an
+// aligned pointer, so that their batches stay aligned.
+inline constexpr size_t range_alignment{host_alignment / sizeof(float)};
+
+struct Add
+{
+  [[nodiscard]] xsimd::batch<float>
+  operator()(xsimd::batch<float> const a, xsimd::batch<float> const b) const
+  {
+    return a + b;
+  }
+
+  [[nodiscard]] constexpr float operator()(float const a, float const b) const { return a + b; }
+};
+
+struct Sub
+{
+  [[nodiscard]] xsimd::batch<float>
+  operator()(xsimd::batch<float> const a, xsimd::batch<float> const b) const
+  {
+    return a - b;
+  }
+
+  [[nodiscard]] constexpr float operator()(float const a, float const b) const { return a - b; }
+};
+
+struct Mul
+{
+  [[nodiscard]] xsimd::batch<float>
+  operator()(xsimd::batch<float> const a, xsimd::batch<float> const b) const
+  {
+    return a * b;
+  }
+
+  [[nodiscard]] constexpr float operator()(float const a, float const b) const { return a * b; }
+};
+
+struct Div
+{
+  [[nodiscard]] xsimd::batch<float>
+  operator()(xsimd::batch<float> const a, xsimd::batch<float> const b) const
+  {
+    return a / b;
+  }
+
+  [[nodiscard]] constexpr float operator()(float const a, float const b) const { return a / b; }
+};
+
+template <class Op>
+void cwisem(float const *a, float const *b, float *c, size_t const size, Op const &op)
+{
+  size_t const vec_size = size - (size % simd_size);
+
+  for (size_t i{0}; i < vec_size; i += simd_size)
+  {
+    auto const ba   = xsimd::load_aligned(&a[i]);
+    auto const bb   = xsimd::load_aligned(&b[i]);
+    auto const bres = op(ba, bb);
+    bres.store_aligned(&c[i]);
+  }
+  for (size_t i{vec_size}; i < size; i++)
+  {
+    c[i] = op(a[i], b[i]);
+  }
+}
+
+template <class Op>
+void cwises(float const *a, float const b, float *c, size_t const size, Op const &op)
+{
+  size_t const vec_size = size - (size % simd_size);
+
+  auto const bb = xsimd::broadcast(b);
+  for (size_t i{0}; i < vec_size; i += simd_size)
+  {
+    auto const ba   = xsimd::load_aligned(&a[i]);
+    auto const bres = op(ba, bb);
+    bres.store_aligned(&c[i]);
+  }
+  for (size_t i{vec_size}; i < size; i++)
+  {
+    c[i] = op(a[i], b);
+  }
+}
+
+// y = alpha * x + y.
+inline void axpy(float const alpha, float const *x, float *y, size_t const size)
+{
+  size_t const vec_size = size - (size % simd_size);
+
+  auto const ba = xsimd::broadcast(alpha);
+  for (size_t i{0}; i < vec_size; i += simd_size)
+  {
+    auto const bx = xsimd::load_aligned(&x[i]);
+    auto const by = xsimd::load_aligned(&y[i]);
+    xsimd::fma(ba, bx, by).store_aligned(&y[i]);
+  }
+  for (size_t i{vec_size}; i < size; i++)
+  {
+    y[i] = std::fma(alpha, x[i], y[i]);
+  }
+}
+
+// y = alpha * x + beta * y.
+inline void
+axpby(float const alpha, float const *x, float const beta, float *y, size_t const size)
+{
+  size_t const vec_size = size - (size % simd_size);
+
+  auto const ba = xsimd::broadcast(alpha);
+  auto const bb = xsimd::broadcast(beta);
+  for (size_t i{0}; i < vec_size; i += simd_size)
+  {
+    auto const bx = xsimd::load_aligned(&x[i]);
+    auto const by = xsimd::load_aligned(&y[i]);
+    xsimd::fma(ba, bx, bb * by).store_aligned(&y[i]);
+  }
+  for (size_t i{vec_size}; i < size; i++)
+  {
+    y[i] = std::fma(alpha, x[i], beta * y[i]);
+  }
+}
+
+inline void fill(float *data, size_t const size, float const value)
+{
+  size_t const vec_size = size - (size % simd_size);
+
+  auto const bv = xsimd::broadcast(value);
+  for (size_t i{0}; i < vec_size; i += simd_size)
+  {
+    bv.store_aligned(&data[i]);
+  }
+  for (size_t i{vec_size}; i < size; i++)
+  {
+    data[i] = value;
+  }
+}
+
+struct Sum
+{
+  [[nodiscard]] static constexpr float init() { return 0.0F; }
+
+  [[nodiscard]] xsimd::batch<float>
+  operator()(xsimd::batch<float> const acc, xsimd::batch<float> const x) const
+  {
+    return acc + x;
+  }
+
+  [[nodiscard]] constexpr float operator()(float const acc, float const x) const { return acc + x; }
+
+  [[nodiscard]] xsimd::batch<float>
+  combine(xsimd::batch<float> const a, xsimd::batch<float> const b) const
+  {
+    return a + b;
+  }
+
+  [[nodiscard]] constexpr float combine(float const a, float const b) const { return a + b; }
+
+  [[nodiscard]] float horizontal(xsimd::batch<float> const acc) const
+  {
+    return xsimd::reduce_add(acc);
+  }
+
+  [[nodiscard]] constexpr float finalize(float const acc) const { return acc; }
+};
+
+struct Max
+{
+  [[nodiscard]] static constexpr float init() { return -std::numeric_limits<float>::infinity(); }
+
+  [[nodiscard]] xsimd::batch<float>
+  operator()(xsimd::batch<float> const acc, xsimd::batch<float> const x) const
+  {
+    return xsimd::max(acc, x);
+  }
+
+  [[nodiscard]] constexpr float operator()(float const acc, float const x) const
+  {
+    return std::max(acc, x);
+  }
+
+  [[nodiscard]] xsimd::batch<float>
+  combine(xsimd::batch<float> const a, xsimd::batch<float> const b) const
+  {
+    return xsimd::max(a, b);
+  }
+
+  [[nodiscard]] constexpr float combine(float const a, float const b) const
+  {
+    return std::max(a, b);
+  }
+
+  [[nodiscard]] float horizontal(xsimd::batch<float> const acc) const
+  {
+    return xsimd::reduce_max(acc);
+  }
+
+  [[nodiscard]] constexpr float finalize(float const acc) const { return acc; }
+};
+
+struct Min
+{
+  [[nodiscard]] static constexpr float init() { return std::numeric_limits<float>::infinity(); }
+
+  [[nodiscard]] xsimd::batch<float>
+  operator()(xsimd::batch<float> const acc, xsimd::batch<float> const x) const
+  {
+    return xsimd::min(acc, x);
+  }
+
+  [[nodiscard]] constexpr float operator()(float const acc, float const x) const
+  {
+    return std::min(acc, x);
+  }
+
+  [[nodiscard]] xsimd::batch<float>
+  combine(xsimd::batch<float> const a, xsimd::batch<float> const b) const
+  {
+    return xsimd::min(a, b);
+  }
+
+  [[nodiscard]] constexpr float combine(float const a, float const b) const
+  {
+    return std::min(a, b);
+  }
+
+  [[nodiscard]] float horizontal(xsimd::batch<float> const acc) const
+  {
+    return xsimd::reduce_min(acc);
+  }
+
+  [[nodiscard]] constexpr float finalize(float const acc) const { return acc; }
+};
+
+struct Norm2
+{
+  [[nodiscard]] static constexpr float init() { return 0.0F; }
+
+  [[nodiscard]] xsimd::batch<float>
+  operator()(xsimd::batch<float> const acc, xsimd::batch<float> const x) const
+  {
+    return xsimd::fma(x, x, acc);
+  }
+
+  [[nodiscard]] float operator()(float const acc, float const x) const
+  {
+    return std::fma(x, x, acc);
+  }
+
+  [[nodiscard]] xsimd::batch<float>
+  combine(xsimd::batch<float> const a, xsimd::batch<float> const b) const
+  {
+    return a + b;
+  }
+
+  [[nodiscard]] constexpr float combine(float const a, float const b) const { return a + b; }
+
+  [[nodiscard]] float horizontal(xsimd::batch<float> const acc) const
+  {
+    return xsimd::reduce_add(acc);
+  }
+
+  [[nodiscard]] float finalize(float const acc) const { return std::sqrt(acc); }
+};
+
+// Several independent batch accumulators hide the latency of the add/fma pipeline, a single
+// accumulator would serialise every iteration on the previous one.
+inline constexpr size_t n_acc{4};
+
+// Reduces a range to a value that still has to go through `op.finalize`, so that the values of
+// several ranges can be combined first.
+template <class Op>
+float reduce_contiguous(float const *data, size_t const size, Op const &op)
+{
+  constexpr size_t step = n_acc * simd_size;
+  size_t const unrolled = size - (size % step);
+  size_t const vec_size = size - (size % simd_size);
+
+  std::array<xsimd::batch<float>, n_acc> acc{};
+  acc.fill(xsimd::broadcast(Op::init()));
+
+  for (size_t i{0}; i < unrolled; i += step)
+  {
+    for (size_t l{0}; l < n_acc; l++)
+    {
+      acc[l] = op(acc[l], xsimd::load_unaligned(&data[i + (l * simd_size)]));
+    }
+  }
+  for (size_t i{unrolled}; i < vec_size; i += simd_size)
+  {
+    acc[0] = op(acc[0], xsimd::load_unaligned(&data[i]));
+  }
+
+  auto bres = acc.front();
+  for (size_t l{1}; l < n_acc; l++)
+  {
+    bres = op.combine(bres, acc[l]);
+  }
+
+  float res = op.horizontal(bres);
+  for (size_t i{vec_size}; i < size; i++)
+  {
+    res = op(res, data[i]);
+  }
+
+  return res;
+}
+
+// The dot product of two ranges.
+inline float dot(float const *a, float const *b, size_t const size)
+{
+  constexpr size_t step = n_acc * simd_size;
+  size_t const unrolled = size - (size % step);
+  size_t const vec_size = size - (size % simd_size);
+
+  std::array<xsimd::batch<float>, n_acc> acc{};
+  acc.fill(xsimd::broadcast(0.0F));
+
+  for (size_t i{0}; i < unrolled; i += step)
+  {
+    for (size_t l{0}; l < n_acc; l++)
+    {
+      auto const offset = i + (l * simd_size);
+      auto const ba     = xsimd::load_aligned(&a[offset]);
+      auto const bb     = xsimd::load_aligned(&b[offset]);
+      acc[l]            = xsimd::fma(ba, bb, acc[l]);
+    }
+  }
+  for (size_t i{unrolled}; i < vec_size; i += simd_size)
+  {
+    auto const ba = xsimd::load_aligned(&a[i]);
+    auto const bb = xsimd::load_aligned(&b[i]);
+    acc[0]        = xsimd::fma(ba, bb, acc[0]);
+  }
+
+  float res = xsimd::reduce_add((acc[0] + acc[1]) + (acc[2] + acc[3]));
+  for (size_t i{vec_size}; i < size; i++)
+  {
+    res = std::fma(a[i], b[i], res);
+  }
+
+  return res;
+}
+
+// Reduces rows [row_begin, row_end) of a row-major matrix with `cols` columns, one value each.
+template <class Op>
+void reduce_rows(
+    float const *a,
+    float *c,
+    size_t const cols,
+    size_t const row_begin,
+    size_t const row_end,
+    Op const &op
+)
+{
+  for (size_t i{row_begin}; i < row_end; i++)
+  {
+    c[i] = op.finalize(reduce_contiguous(&a[i * cols], cols, op));
+  }
+}
+
+// Accumulates rows [row_begin, row_end) of a row-major matrix with `cols` columns into `acc`,
+// which must be aligned and hold one value per column. The rows are streamed in memory order,
+// the lanes of `acc` are the accumulators.
+template <class Op>
+void accumulate_rows(
+    float const *a,
+    float *acc,
+    size_t const cols,
+    size_t const row_begin,
+    size_t const row_end,
+    Op const &op
+)
+{
+  size_t const vec_cols = cols - (cols % simd_size);
+
+  for (size_t i{row_begin}; i < row_end; i++)
+  {
+    float const *row = &a[i * cols];
+    for (size_t j{0}; j < vec_cols; j += simd_size)
+    {
+      auto const bc = xsimd::load_aligned(&acc[j]);
+      op(bc, xsimd::load_unaligned(&row[j])).store_aligned(&acc[j]);
+    }
+    for (size_t j{vec_cols}; j < cols; j++)
+    {
+      acc[j] = op(acc[j], row[j]);
+    }
+  }
+}
+
+// c = a * b for an m x k block of a and a k x n block of b, stored row-major with leading
+// dimensions `lda` and `ldb`, into an m x n block of c with leading dimension `ldc`. The product
+// is added to c unless `overwrite` is set. Rows of a block only start aligned when the leading
+// dimension is a multiple of the batch size, so blocks are accessed with unaligned loads.
+inline void gemm(
+    float const *a,
+    size_t const lda,
+    float const *b,
+    size_t const ldb,
+    float *c,
+    size_t const ldc,
+    size_t const m,
+    size_t const n,
+    size_t const k,
+    bool const overwrite
+)
+{
+  size_t const n_simd = n - (n % simd_size);
+
+  for (size_t i{0}; i < m; i++)
+  {
+    float *c_row = &c[i * ldc];
+    if (overwrite)
+    {
+      std::fill_n(c_row, n, 0.0F);
+    }
+
+    for (size_t p{0}; p < k; p++)
+    {
+      float const a_ip   = a[(i * lda) + p];
+      auto const ba      = xsimd::broadcast(a_ip);
+      float const *b_row = &b[p * ldb];
+
+      for (size_t j{0}; j < n_simd; j += simd_size)
+      {
+        auto const bc = xsimd::load_unaligned(&c_row[j]);
+        auto const bb = xsimd::load_unaligned(&b_row[j]);
+        xsimd::fma(ba, bb, bc).store_unaligned(&c_row[j]);
+      }
+      for (size_t j{n_simd}; j < n; j++)
+      {
+        c_row[j] = std::fma(a_ip, b_row[j], c_row[j]);
+      }
+    }
+  }
+}
+
+// Writes the rows x cols block `from`, of leading dimension `ld_from`, transposed into `to`, of
+// leading dimension `ld_to`.
+inline void transpose(
+    float const *from,
+    size_t const ld_from,
+    float *to,
+    size_t const ld_to,
+    size_t const rows,
+    size_t const cols
+)
+{
+  for (size_t i{0}; i < rows; i++)
+  {
+    for (size_t j{0}; j < cols; j++)
+    {
+      to[(j * ld_to) + i] = from[(i * ld_from) + j];
+    }
+  }
+}
+
+template <class Op>
+void eval_block_op(
+    EvalSlot const &lhs, EvalSlot const &rhs, float *dst, size_t const len, Op const &op
+)
+{
+  size_t const vec_len = len - (len % simd_size);
+
+  if (lhs.data != nullptr and rhs.data != nullptr)
+  {
+    for (size_t i{0}; i < vec_len; i += simd_size)
+    {
+      auto const bl = xsimd::load_aligned(&lhs.data[i]);
+      auto const br = xsimd::load_aligned(&rhs.data[i]);
+      op(bl, br).store_aligned(&dst[i]);
+    }
+    for (size_t i{vec_len}; i < len; i++)
+    {
+      dst[i] = op(lhs.data[i], rhs.data[i]);
+    }
+  }
+  else if (lhs.data != nullptr)
+  {
+    auto const br = xsimd::broadcast(rhs.scalar);
+    for (size_t i{0}; i < vec_len; i += simd_size)
+    {
+      auto const bl = xsimd::load_aligned(&lhs.data[i]);
+      op(bl, br).store_aligned(&dst[i]);
+    }
+    for (size_t i{vec_len}; i < len; i++)
+    {
+      dst[i] = op(lhs.data[i], rhs.scalar);
+    }
+  }
+  else if (rhs.data != nullptr)
+  {
+    auto const bl = xsimd::broadcast(lhs.scalar);
+    for (size_t i{0}; i < vec_len; i += simd_size)
+    {
+      auto const br = xsimd::load_aligned(&rhs.data[i]);
+      op(bl, br).store_aligned(&dst[i]);
+    }
+    for (size_t i{vec_len}; i < len; i++)
+    {
+      dst[i] = op(lhs.scalar, rhs.data[i]);
+    }
+  }
+  else
+  {
+    std::fill_n(dst, len, op(lhs.scalar, rhs.scalar));
+  }
+}
+
+inline void eval_block_op(
+    ExprOp const op, EvalSlot const &lhs, EvalSlot const &rhs, float *dst, size_t const len
+)
+{
+  switch (op)
+  {
+  case ExprOp::ADD:
+    eval_block_op(lhs, rhs, dst, len, Add{});
+    break;
+  case ExprOp::SUB:
+    eval_block_op(lhs, rhs, dst, len, Sub{});
+    break;
+  case ExprOp::MUL:
+    eval_block_op(lhs, rhs, dst, len, Mul{});
+    break;
+  case ExprOp::DIV:
+    eval_block_op(lhs, rhs, dst, len, Div{});
+    break;
+  case ExprOp::LOAD:
+  case ExprOp::LOAD_SCALAR:
+    break;
+  }
+}
+
+// Evaluates elements [begin, end) of `program`, `begin` must be a multiple of `range_alignment`.
+// `operands` holds the host memory of the program operands.
+inline void eval(
+    ExprProgram const &program,
+    std::vector<float const *> const &operands,
+    float *out,
+    size_t const begin,
+    size_t const end
+)
+{
+  eval_program(
+      program,
+      operands,
+      out,
+      begin,
+      end,
+      [](ExprOp const op, EvalSlot const &lhs, EvalSlot const &rhs, float *dst, size_t const len)
+      { eval_block_op(op, lhs, rhs, dst, len); }
+  );
+}
+
+} // namespace gpu_playground::backend::simd
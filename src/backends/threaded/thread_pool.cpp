@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "thread_pool.hpp"
+
+namespace gpu_playground::backend
+{
+
+namespace
+{
+
+// The number of cores the process may run on, or zero where that is unknown.
+size_t allowed_cores()
+{
+#if defined(__linux__)
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+  {
+    return static_cast<size_t>(CPU_COUNT(&allowed));
+  }
+#endif
+  return 0;
+}
+
+// Pins the calling thread to the `index`-th core the process may run on. Pinning keeps a worker
+// on the core whose caches hold its last chunk, it is best effort and skipped where unsupported.
+void pin_to_core([[maybe_unused]] size_t const index)
+{
+#if defined(__linux__)
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+  {
+    return;
+  }
+
+  auto const n_cores = static_cast<size_t>(CPU_COUNT(&allowed));
+  if (n_cores == 0)
+  {
+    return;
+  }
+
+  size_t nth = index % n_cores;
+  for (int cpu{0}; cpu < CPU_SETSIZE; cpu++)
+  {
+    if (CPU_ISSET(cpu, &allowed) and nth-- == 0)
+    {
+      cpu_set_t target;
+      CPU_ZERO(&target);
+      CPU_SET(cpu, &target);
+      pthread_setaffinity_np(pthread_self(), sizeof(target), &target);
+      return;
+    }
+  }
+#endif
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t num_threads)
+{
+  if (num_threads == 0)
+  {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  this->slots.reserve(num_threads);
+  for (size_t t{0}; t < num_threads; t++)
+  {
+    this->slots.push_back(std::make_unique<Slot>());
+    this->slots.back()->seed = t + 1;
+  }
+
+  // Worker w is pinned to the w-th core, so only a pool spanning every core pins its workers: a
+  // smaller one would stack with the other pools of the process on the first cores.
+  auto const n_cores = allowed_cores();
+  bool const pin     = n_cores != 0 and num_threads >= n_cores;
+
+  this->workers.reserve(num_threads - 1);
+  for (size_t w{1}; w < num_threads; w++)
+  {
+    this->workers.emplace_back([this, w, pin]() { this->worker_loop(w, pin); });
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> const lock{this->mutex};
+    this->stop = true;
+  }
+  this->wake.notify_all();
+
+  for (auto &worker : this->workers)
+  {
+    worker.join();
+  }
+}
+
+thread_local ThreadPool const *ThreadPool::current_pool{nullptr};
+thread_local ThreadPool::Slot *ThreadPool::current{nullptr};
+
+Job *ThreadPool::steal(Slot &thief)
+{
+  // Start from a random victim, so that thieves spread over the deques.
+  thief.seed ^= thief.seed << 13;
+  thief.seed ^= thief.seed >> 7;
+  thief.seed ^= thief.seed << 17;
+
+  size_t const n_slots = this->slots.size();
+  size_t const first   = thief.seed % n_slots;
+  for (size_t s{0}; s < n_slots; s++)
+  {
+    auto &victim = *this->slots[(first + s) % n_slots];
+    if (&victim == &thief)
+    {
+      continue;
+    }
+    if (Job *job = victim.deque.steal(); job != nullptr)
+    {
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+void ThreadPool::wait_for(Job const &job, Slot &slot)
+{
+  while (not job.finished())
+  {
+    if (Job *other = this->steal(slot); other != nullptr)
+    {
+      other->execute();
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void ThreadPool::run_region(
+    Job &root, std::function<void(size_t)> const *tasks, size_t const n_tasks
+)
+{
+  {
+    std::lock_guard<std::mutex> const lock{this->mutex};
+    this->assigned    = tasks;
+    this->n_assigned  = n_tasks;
+    this->region_done = false;
+    this->active      = this->workers.size();
+    this->generation++;
+  }
+  this->wake.notify_all();
+
+  auto const *previous_pool = std::exchange(current_pool, this);
+  auto *previous            = std::exchange(current, this->slots.front().get());
+  root.execute();
+  current_pool = previous_pool;
+  current      = previous;
+
+  // Every forked job has been joined by now, the workers only have to notice.
+  this->region_done = true;
+  std::unique_lock<std::mutex> lock{this->mutex};
+  this->done.wait(lock, [this]() { return this->active == 0; });
+}
+
+void ThreadPool::worker_loop(size_t const index, bool const pin)
+{
+  if (pin)
+  {
+    pin_to_core(index);
+  }
+
+  auto &slot   = *this->slots[index];
+  current_pool = this;
+  current      = &slot;
+
+  uint64_t seen{0};
+  std::unique_lock<std::mutex> lock{this->mutex};
+  while (true)
+  {
+    this->wake.wait(lock, [this, seen]() { return this->stop or this->generation != seen; });
+    if (this->stop)
+    {
+      return;
+    }
+    seen                 = this->generation;
+    auto const *tasks    = this->assigned;
+    size_t const n_tasks = this->n_assigned;
+
+    lock.unlock();
+    if (tasks != nullptr and index < n_tasks)
+    {
+      (*tasks)(index);
+    }
+    while (not this->region_done)
+    {
+      if (Job *job = this->steal(slot); job != nullptr)
+      {
+        job->execute();
+      }
+      else
+      {
+        std::this_thread::yield();
+      }
+    }
+    lock.lock();
+
+    if (--this->active == 0)
+    {
+      this->done.notify_one();
+    }
+  }
+}
+
+} // namespace gpu_playground::backend
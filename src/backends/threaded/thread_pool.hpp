@@ -0,0 +1,220 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "work_deque.hpp"
+
+namespace gpu_playground::backend
+{
+
+// A split of [0, size) into `count` ranges of `length` elements, the last one shorter.
+struct Partition
+{
+  size_t size;
+  size_t count;
+  size_t length;
+
+  [[nodiscard]] size_t begin(size_t const chunk) const { return std::min(chunk * length, size); }
+
+  [[nodiscard]] size_t end(size_t const chunk) const
+  {
+    return std::min((chunk + 1) * length, size);
+  }
+};
+
+// A fixed set of worker threads, started once, scheduling fork-join parallelism by work stealing.
+// Every thread owns a deque of the jobs it forked and, when out of work, steals the oldest job of
+// another thread. Recursive kernels then balance by themselves: a thread that finishes early
+// takes half of what is left to another one. A pool spanning every core the process may use pins
+// each worker to its own core.
+//
+// Loops over ranges are scheduled statically instead: range t always runs on thread t, so that a
+// thread keeps working on the pages it touched first, which sit on its own NUMA node.
+//
+// The calling thread takes part in the work, so a pool of `n` threads starts `n - 1` workers.
+class ThreadPool
+{
+private:
+  struct Slot
+  {
+    WorkDeque deque;
+    // The state of the generator picking steal victims.
+    uint64_t seed{0};
+  };
+
+  std::vector<std::thread> workers;
+  // One slot per thread, the first one for the calling thread.
+  std::vector<std::unique_ptr<Slot>> slots;
+
+  // Held by the caller whose region the workers run. Other callers do not wait for it: while the
+  // pool is busy, their work runs on their own thread.
+  std::mutex submit;
+
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  uint64_t generation{0};
+  size_t active{0};
+  bool stop{false};
+  std::atomic<bool> region_done{false};
+  // The tasks of the current region assigned to a thread each, thread t runs `(*assigned)(t)`.
+  std::function<void(size_t)> const *assigned{nullptr};
+  size_t n_assigned{0};
+
+  // The pool whose jobs the current thread runs, and the slot of the thread in it.
+  static thread_local ThreadPool const *current_pool;
+  static thread_local Slot *current;
+
+  // The slot of the calling thread when it runs jobs of this pool, null otherwise.
+  [[nodiscard]] Slot *current_slot() const
+  {
+    return ThreadPool::current_pool == this ? ThreadPool::current : nullptr;
+  }
+
+  // Takes a job from the deque of another thread, or returns null.
+  [[nodiscard]] Job *steal(Slot &thief);
+
+  // Runs other jobs until `job`, forked from `slot` and stolen, has completed.
+  void wait_for(Job const &job, Slot &slot);
+
+  // Runs `root` on the calling thread while the workers run their assigned task, if any, then
+  // steal the jobs it forks. The caller holds `submit`.
+  void run_region(Job &root, std::function<void(size_t)> const *tasks, size_t n_tasks);
+
+  // Takes the pool for a region of the calling thread. The lock is empty when the pool has no
+  // worker, the thread already runs jobs of the pool, or another caller holds it.
+  [[nodiscard]] std::unique_lock<std::mutex> acquire()
+  {
+    if (this->workers.empty() or this->current_slot() != nullptr)
+    {
+      return {};
+    }
+    return std::unique_lock<std::mutex>{this->submit, std::try_to_lock};
+  }
+
+  void worker_loop(size_t index, bool pin);
+
+public:
+  // Starts `num_threads - 1` workers, or one per available core when `num_threads` is zero.
+  explicit ThreadPool(size_t num_threads);
+
+  ThreadPool(ThreadPool const &)            = delete;
+  ThreadPool(ThreadPool &&)                 = delete;
+  ThreadPool &operator=(ThreadPool const &) = delete;
+  ThreadPool &operator=(ThreadPool &&)      = delete;
+  ~ThreadPool();
+
+  // The number of threads taking part in the work, the caller included.
+  [[nodiscard]] size_t size() const { return this->workers.size() + 1; }
+
+  // Runs `root` with the workers of the pool, returns once it and every job it forked have
+  // completed. Inside `root`, `fork_join` runs in parallel. When the pool is busy with another
+  // caller, `root` runs on the calling thread alone.
+  template <class F>
+  void parallel(F const &root)
+  {
+    auto const submit_lock = this->acquire();
+    if (not submit_lock.owns_lock())
+    {
+      root();
+      return;
+    }
+
+    FnJob<F> job{root};
+    this->run_region(job, nullptr, 0);
+  }
+
+  // Runs `a` and `b`, possibly in parallel, and returns once both have completed. `b` is offered
+  // to the other threads while the calling thread runs `a`. Outside of `parallel` both run on
+  // the calling thread.
+  template <class A, class B>
+  void fork_join(A const &a, B const &b)
+  {
+    Slot *slot = this->current_slot();
+    FnJob<B> job{b};
+    if (slot == nullptr or not slot->deque.push(&job))
+    {
+      a();
+      b();
+      return;
+    }
+
+    a();
+
+    // Jobs forked by `a` have all been joined, so the bottom of the deque is `job` unless it was
+    // stolen.
+    if (slot->deque.pop() == &job)
+    {
+      b();
+      return;
+    }
+    this->wait_for(job, *slot);
+  }
+
+  // Runs `task(t)` for every t in [0, n_tasks) and returns once all of them have completed.
+  // Task t runs on thread t, the calling thread being thread 0, and the tasks past the size of
+  // the pool run on the calling thread. Inside `parallel`, or when the pool is busy with another
+  // caller, all of them run on the calling thread.
+  template <class F>
+  void run(size_t const n_tasks, F const &task)
+  {
+    auto const submit_lock = n_tasks > 1 ? this->acquire() : std::unique_lock<std::mutex>{};
+    if (not submit_lock.owns_lock())
+    {
+      for (size_t t{0}; t < n_tasks; t++)
+      {
+        task(t);
+      }
+      return;
+    }
+
+    std::function<void(size_t)> const tasks{[&task](size_t const t) -> void { task(t); }};
+    auto const root = [this, n_tasks, &task]() -> void
+    {
+      task(0);
+      for (size_t t{this->size()}; t < n_tasks; t++)
+      {
+        task(t);
+      }
+    };
+    FnJob<decltype(root)> job{root};
+    this->run_region(job, &tasks, n_tasks);
+  }
+
+  // Splits [0, size) into at most one range per thread. Ranges are a multiple of `grain` long,
+  // apart from the last, so that a range of fewer than `grain` elements is never worth a thread.
+  [[nodiscard]] Partition partition(size_t const size, size_t const grain) const
+  {
+    size_t const count  = std::clamp<size_t>((size + grain - 1) / grain, 1, this->size());
+    size_t const length = (((size + count - 1) / count) + grain - 1) / grain * grain;
+    return {size, count, std::max<size_t>(length, 1)};
+  }
+
+  // Runs `fn(begin, end)` over the ranges of `partition(size, grain)`, range t on thread t.
+  template <class F>
+  void parallel_for(size_t const size, size_t const grain, F const &fn)
+  {
+    auto const part = this->partition(size, grain);
+    if (part.count == 1)
+    {
+      fn(size_t{0}, size);
+      return;
+    }
+
+    this->run(
+        part.count,
+        [&part, &fn](size_t const chunk) -> void { fn(part.begin(chunk), part.end(chunk)); }
+    );
+  }
+};
+
+} // namespace gpu_playground::backend
@@ -0,0 +1,607 @@
+#include <algorithm>
+#include <vector>
+
+#include "host_storage.hpp"
+#include "reproducible.hpp"
+#include "simd_kernels.hpp"
+#include "threaded_device.hpp"
+
+namespace gpu_playground::backend
+{
+
+namespace
+{
+
+// Ranges smaller than this many floats stay on the calling thread, waking a worker costs more
+// than the work. Ranges are a multiple of it, which keeps them aligned and made of whole
+// evaluation blocks.
+constexpr size_t parallel_grain{size_t{1} << 14};
+
+static_assert(parallel_grain % simd::range_alignment == 0);
+static_assert(parallel_grain % eval_block == 0);
+
+// Products with fewer multiply-adds than this run on the calling thread.
+constexpr size_t gemm_parallel_work{size_t{1} << 18};
+
+// The recursive kernels split a block until the data it touches fits in this many floats, a
+// share of a core's L2 cache.
+constexpr size_t gemm_leaf{size_t{1} << 15};
+constexpr size_t transpose_leaf{size_t{1} << 12};
+
+// The number of rows holding about `parallel_grain` floats.
+size_t row_grain(size_t const cols) { return std::max<size_t>(1, parallel_grain / cols); }
+
+// Runs the leaves of a reproducible reduction on the pool, which only changes who computes them.
+struct PoolForEach
+{
+  ThreadPool &workers;
+
+  template <class F>
+  void operator()(size_t const size, size_t const grain, F const &fn) const
+  {
+    this->workers.parallel_for(size, grain, fn);
+  }
+};
+
+template <class Op>
+void cwisem_op(ThreadPool &workers, Buffer const &a, Buffer const &b, Buffer &c, Op const &op)
+{
+  assert_same_shape(a, b, c);
+
+  auto const *threaded_a = host_ptr(a);
+  auto const *threaded_b = host_ptr(b);
+  auto *threaded_c       = host_ptr(c);
+
+  workers.parallel_for(
+      a.size(),
+      parallel_grain,
+      [&](size_t const begin, size_t const end)
+      {
+        simd::cwisem(
+            &threaded_a[begin], &threaded_b[begin], &threaded_c[begin], end - begin, op
+        );
+      }
+  );
+}
+
+template <class Op>
+void cwises_op(ThreadPool &workers, Buffer const &a, Buffer const &b, Buffer &c, Op const &op)
+{
+  assert_compatible_sop(a, b, c);
+
+  auto const *threaded_a = host_ptr(a);
+  auto const scalar_b    = host_ptr(b)[0];
+  auto *threaded_c       = host_ptr(c);
+
+  workers.parallel_for(
+      a.size(),
+      parallel_grain,
+      [&](size_t const begin, size_t const end)
+      { simd::cwises(&threaded_a[begin], scalar_b, &threaded_c[begin], end - begin, op); }
+  );
+}
+
+template <class Op>
+void reduce_op(ThreadPool &workers, Buffer const &a, Buffer &c, Axis const axis, Op const &op)
+{
+  assert_compatible_reduce(a, c, axis);
+
+  auto const *threaded_a = host_ptr(a);
+  auto *threaded_c       = host_ptr(c);
+
+  auto const [rows, cols] = a.shape();
+
+  switch (axis)
+  {
+  case Axis::ROWS:
+    workers.parallel_for(
+        rows,
+        row_grain(cols),
+        [&](size_t const begin, size_t const end)
+        { simd::reduce_rows(threaded_a, threaded_c, cols, begin, end, op); }
+    );
+    break;
+  case Axis::COLS:
+  {
+    // Every range of rows accumulates into its own row of partial values, the partial rows are
+    // then combined in order.
+    auto const part     = workers.partition(rows, row_grain(cols));
+    size_t const stride = (cols + simd::range_alignment - 1) / simd::range_alignment *
+                          simd::range_alignment;
+
+    simd::AlignedVector partials(part.count * stride);
+    workers.run(
+        part.count,
+        [&](size_t const chunk)
+        {
+          float *acc = &partials[chunk * stride];
+          std::fill_n(acc, cols, Op::init());
+          simd::accumulate_rows(threaded_a, acc, cols, part.begin(chunk), part.end(chunk), op);
+        }
+    );
+
+    for (size_t j{0}; j < cols; j++)
+    {
+      float res = partials[j];
+      for (size_t chunk{1}; chunk < part.count; chunk++)
+      {
+        res = op.combine(res, partials[(chunk * stride) + j]);
+      }
+      threaded_c[j] = op.finalize(res);
+    }
+    break;
+  }
+  case Axis::ALL:
+  {
+    auto const part = workers.partition(a.size(), parallel_grain);
+
+    std::vector<float> partials(part.count);
+    workers.run(
+        part.count,
+        [&](size_t const chunk)
+        {
+          auto const begin = part.begin(chunk);
+          auto const end   = part.end(chunk);
+          partials[chunk]  = simd::reduce_contiguous(&threaded_a[begin], end - begin, op);
+        }
+    );
+
+    float res = partials.front();
+    for (size_t chunk{1}; chunk < part.count; chunk++)
+    {
+      res = op.combine(res, partials[chunk]);
+    }
+    threaded_c[0] = op.finalize(res);
+    break;
+  }
+  }
+}
+
+// An m x n block of c = a * b, with the k columns of a and rows of b it depends on.
+struct GemmBlock
+{
+  float const *a;
+  size_t lda;
+  float const *b;
+  size_t ldb;
+  float *c;
+  size_t ldc;
+  size_t m;
+  size_t n;
+  size_t k;
+};
+
+// Splits the largest dimension of the product in two until the blocks fit in cache, so that the
+// work divides evenly whatever the shape. Halves of m and n are independent and forked. Halves
+// of k add up into the same block of c: when that block is small, the second half is forked
+// into scratch space and added after the join, otherwise they run one after the other.
+void mul_recursive(ThreadPool &workers, GemmBlock const &blk, bool const overwrite)
+{
+  auto const [a, lda, b, ldb, c, ldc, m, n, k] = blk;
+
+  if ((m * k) + (k * n) + (m * n) <= gemm_leaf)
+  {
+    simd::gemm(a, lda, b, ldb, c, ldc, m, n, k, overwrite);
+    return;
+  }
+
+  if (m >= n and m >= k)
+  {
+    size_t const mid = m / 2;
+    workers.fork_join(
+        [&]() { mul_recursive(workers, {a, lda, b, ldb, c, ldc, mid, n, k}, overwrite); },
+        [&]()
+        {
+          GemmBlock const bottom{
+              &a[mid * lda], lda, b, ldb, &c[mid * ldc], ldc, m - mid, n, k
+          };
+          mul_recursive(workers, bottom, overwrite);
+        }
+    );
+  }
+  else if (n >= k)
+  {
+    // Split on a batch boundary, so the columns of the left half fill whole batches.
+    size_t const half = n / 2;
+    size_t const mid  = half >= simd::simd_size ? half / simd::simd_size * simd::simd_size : half;
+    workers.fork_join(
+        [&]() { mul_recursive(workers, {a, lda, b, ldb, c, ldc, m, mid, k}, overwrite); },
+        [&]()
+        {
+          GemmBlock const right{a, lda, &b[mid], ldb, &c[mid], ldc, m, n - mid, k};
+          mul_recursive(workers, right, overwrite);
+        }
+    );
+  }
+  else
+  {
+    size_t const mid = k / 2;
+    GemmBlock const front{a, lda, b, ldb, c, ldc, m, n, mid};
+    GemmBlock back{&a[mid], lda, &b[mid * ldb], ldb, c, ldc, m, n, k - mid};
+
+    if (m * n > gemm_leaf)
+    {
+      mul_recursive(workers, front, overwrite);
+      mul_recursive(workers, back, false);
+      return;
+    }
+
+    simd::AlignedVector scratch(m * n);
+    back.c   = scratch.data();
+    back.ldc = n;
+    workers.fork_join(
+        [&]() { mul_recursive(workers, front, overwrite); },
+        [&]() { mul_recursive(workers, back, true); }
+    );
+    for (size_t i{0}; i < m; i++)
+    {
+      for (size_t j{0}; j < n; j++)
+      {
+        c[(i * ldc) + j] += scratch[(i * n) + j];
+      }
+    }
+  }
+}
+
+// Splits the largest dimension until the source and destination blocks fit in cache, the halves
+// are independent and forked.
+void transpose_recursive(
+    ThreadPool &workers,
+    float const *from,
+    size_t const ld_from,
+    float *to,
+    size_t const ld_to,
+    size_t const rows,
+    size_t const cols
+)
+{
+  if (rows * cols <= transpose_leaf)
+  {
+    simd::transpose(from, ld_from, to, ld_to, rows, cols);
+    return;
+  }
+
+  if (rows >= cols)
+  {
+    size_t const mid = rows / 2;
+    workers.fork_join(
+        [&]() { transpose_recursive(workers, from, ld_from, to, ld_to, mid, cols); },
+        [&]()
+        {
+          transpose_recursive(
+              workers, &from[mid * ld_from], ld_from, &to[mid], ld_to, rows - mid, cols
+          );
+        }
+    );
+  }
+  else
+  {
+    size_t const mid = cols / 2;
+    workers.fork_join(
+        [&]() { transpose_recursive(workers, from, ld_from, to, ld_to, rows, mid); },
+        [&]()
+        {
+          transpose_recursive(
+              workers, &from[mid], ld_from, &to[mid * ld_to], ld_to, rows, cols - mid
+          );
+        }
+    );
+  }
+}
+
+} // namespace
+
+ThreadedDevice::ThreadedDevice(size_t const num_threads)
+    : workers(std::make_unique<ThreadPool>(num_threads))
+{
+}
+
+void ThreadedDevice::add(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  cwisem_op(*this->workers, a, b, c, simd::Add{});
+}
+
+void ThreadedDevice::sub(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  cwisem_op(*this->workers, a, b, c, simd::Sub{});
+}
+
+void ThreadedDevice::mul(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  assert_compatible_mul(a, b, c);
+
+  auto const [m, k] = a.shape();
+  auto const n      = b.shape().cols;
+  GemmBlock const blk{host_ptr(a), k, host_ptr(b), n, host_ptr(c), n, m, n, k};
+
+  if (m * n * k < gemm_parallel_work)
+  {
+    simd::gemm(blk.a, blk.lda, blk.b, blk.ldb, blk.c, blk.ldc, m, n, k, true);
+    return;
+  }
+
+  this->workers->parallel([&]() { mul_recursive(*this->workers, blk, true); });
+}
+
+void ThreadedDevice::cmul(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  cwisem_op(*this->workers, a, b, c, simd::Mul{});
+}
+
+void ThreadedDevice::cdiv(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  cwisem_op(*this->workers, a, b, c, simd::Div{});
+}
+
+void ThreadedDevice::sadd(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  cwises_op(*this->workers, a, b, c, simd::Add{});
+}
+
+void ThreadedDevice::ssub(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  cwises_op(*this->workers, a, b, c, simd::Sub{});
+}
+
+void ThreadedDevice::smul(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  cwises_op(*this->workers, a, b, c, simd::Mul{});
+}
+
+void ThreadedDevice::sdiv(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  cwises_op(*this->workers, a, b, c, simd::Div{});
+}
+
+void ThreadedDevice::axpy(Buffer const &alpha, Buffer const &x, Buffer &y) const
+{
+  assert_compatible_axpy(alpha, x, y);
+
+  auto const scalar_alpha = host_ptr(alpha)[0];
+  auto const *threaded_x  = host_ptr(x);
+  auto *threaded_y        = host_ptr(y);
+
+  this->workers->parallel_for(
+      y.size(),
+      parallel_grain,
+      [&](size_t const begin, size_t const end)
+      { simd::axpy(scalar_alpha, &threaded_x[begin], &threaded_y[begin], end - begin); }
+  );
+}
+
+void ThreadedDevice::axpby(
+    Buffer const &alpha, Buffer const &x, Buffer const &beta, Buffer &y
+) const
+{
+  assert_compatible_axpy(alpha, x, y);
+  assert_compatible_axpy(beta, x, y);
+
+  auto const scalar_alpha = host_ptr(alpha)[0];
+  auto const scalar_beta  = host_ptr(beta)[0];
+  auto const *threaded_x  = host_ptr(x);
+  auto *threaded_y        = host_ptr(y);
+
+  this->workers->parallel_for(
+      y.size(),
+      parallel_grain,
+      [&](size_t const begin, size_t const end)
+      {
+        simd::axpby(
+            scalar_alpha, &threaded_x[begin], scalar_beta, &threaded_y[begin], end - begin
+        );
+      }
+  );
+}
+
+void ThreadedDevice::dot(Buffer const &a, Buffer const &b, Buffer &c) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::dot(a, b, c, PoolForEach{*this->workers});
+    return;
+  }
+
+  assert_compatible_dot(a, b, c);
+
+  auto const *threaded_a = host_ptr(a);
+  auto const *threaded_b = host_ptr(b);
+
+  auto const part = this->workers->partition(a.size(), parallel_grain);
+
+  std::vector<float> partials(part.count);
+  this->workers->run(
+      part.count,
+      [&](size_t const chunk)
+      {
+        auto const begin = part.begin(chunk);
+        auto const end   = part.end(chunk);
+        partials[chunk]  = simd::dot(&threaded_a[begin], &threaded_b[begin], end - begin);
+      }
+  );
+
+  float res{0.0F};
+  for (auto const partial : partials)
+  {
+    res += partial;
+  }
+  host_ptr(c)[0] = res;
+}
+
+void ThreadedDevice::sum(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Sum>(a, c, axis, PoolForEach{*this->workers});
+    return;
+  }
+
+  reduce_op(*this->workers, a, c, axis, simd::Sum{});
+}
+
+void ThreadedDevice::max(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Max>(a, c, axis, PoolForEach{*this->workers});
+    return;
+  }
+
+  reduce_op(*this->workers, a, c, axis, simd::Max{});
+}
+
+void ThreadedDevice::min(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Min>(a, c, axis, PoolForEach{*this->workers});
+    return;
+  }
+
+  reduce_op(*this->workers, a, c, axis, simd::Min{});
+}
+
+void ThreadedDevice::norm2(Buffer const &a, Buffer &c, Axis const axis) const
+{
+  if (reproducible_reductions())
+  {
+    reproducible::reduce<reproducible::Norm2>(a, c, axis, PoolForEach{*this->workers});
+    return;
+  }
+
+  reduce_op(*this->workers, a, c, axis, simd::Norm2{});
+}
+
+void ThreadedDevice::eval(ExprProgram const &program, Buffer &out) const
+{
+  assert_compatible_eval(program, out);
+
+  auto *threaded_out = host_ptr(out);
+
+  auto const operands = host_operands(program);
+
+  this->workers->parallel_for(
+      out.size(),
+      parallel_grain,
+      [&](size_t const begin, size_t const end)
+      { simd::eval(program, operands, threaded_out, begin, end); }
+  );
+}
+
+Buffer ThreadedDevice::new_buffer(std::vector<float> data, Shape shape) const
+{
+  auto buffer = this->new_buffer_uninitialized(shape);
+  auto *dest  = host_ptr(buffer);
+
+  // Copied with the split of the kernels too, so that the pages keep their first-touch placement
+  // when the policy leaves them to the first write.
+  this->workers->parallel_for(
+      data.size(),
+      parallel_grain,
+      [&](size_t const begin, size_t const end)
+      { std::copy(data.data() + begin, data.data() + end, dest + begin); }
+  );
+  return buffer;
+}
+
+Buffer ThreadedDevice::new_buffer_uninitialized(Shape shape) const
+{
+  // Every thread touches the range the element-wise kernels will hand it, so its pages land on
+  // the NUMA node of that thread.
+  auto const first_touch = [this](float *data, size_t const size) -> void
+  {
+    this->workers->parallel_for(
+        size,
+        parallel_grain,
+        [data](size_t const begin, size_t const end) { prefault(&data[begin], end - begin); }
+    );
+  };
+  return Buffer{
+      new_host_storage(shape.rows * shape.cols, first_touch), shape, ThreadedDevice::s_type
+  };
+}
+
+void ThreadedDevice::fill(Buffer &buffer, float const value) const
+{
+  assert_compatible_fill(buffer);
+
+  auto *threaded_buffer = host_ptr(buffer);
+
+  this->workers->parallel_for(
+      buffer.size(),
+      parallel_grain,
+      [&](size_t const begin, size_t const end)
+      { simd::fill(&threaded_buffer[begin], end - begin, value); }
+  );
+}
+
+void ThreadedDevice::fill_random(Buffer &buffer, Distribution const dist, uint64_t const seed) const
+{
+  assert_compatible_fill(buffer);
+
+  auto *threaded_buffer = host_ptr(buffer);
+  size_t const size     = buffer.size();
+  Philox const philox{seed};
+
+  // Split on blocks of four values, each worker generating its own blocks from the counter.
+  this->workers->parallel_for(
+      (size + 3) / 4,
+      parallel_grain / 4,
+      [&](size_t const begin, size_t const end)
+      { fill_random_blocks(threaded_buffer, size, begin, end, dist, philox); }
+  );
+}
+
+void ThreadedDevice::copy_buffer(Buffer const &from, Buffer &to) const
+{
+  assert_compatible_copy(from, to);
+
+  auto const *threaded_from = host_ptr(from);
+  auto *threaded_to         = host_ptr(to);
+
+  this->workers->parallel_for(
+      from.size(),
+      parallel_grain,
+      [&](size_t const begin, size_t const end)
+      { std::copy(&threaded_from[begin], &threaded_from[end], &threaded_to[begin]); }
+  );
+}
+
+void ThreadedDevice::transpose(Buffer const &from, Buffer &to) const
+{
+  assert_compatible_transpose(from, to);
+
+  auto const *threaded_from = host_ptr(from);
+  auto *threaded_to         = host_ptr(to);
+
+  auto const [rows, cols] = from.shape();
+  auto &workers           = *this->workers;
+  if (from.size() < parallel_grain)
+  {
+    transpose_recursive(workers, threaded_from, cols, threaded_to, rows, rows, cols);
+    return;
+  }
+
+  workers.parallel(
+      [&]() { transpose_recursive(workers, threaded_from, cols, threaded_to, rows, rows, cols); }
+  );
+}
+
+std::vector<float> ThreadedDevice::cpu(Buffer const &buffer) const
+{
+  auto const *threaded_buffer = host_ptr(buffer);
+  return {threaded_buffer, threaded_buffer + buffer.size()};
+}
+
+float const *ThreadedDevice::host_data(Buffer const &buffer) const
+{
+  return host_ptr(buffer);
+}
+
+void ThreadedDevice::sync([[maybe_unused]] Buffer const &buffer) const {}
+
+} // namespace gpu_playground::backend
+
+gpu_playground::DevicePtr gpu_playground::make_threaded_device(size_t const num_threads)
+{
+  return std::make_shared<gpu_playground::backend::ThreadedDevice>(num_threads);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <memory>
+
+#include "device.hpp"
+#include "thread_pool.hpp"
+
+namespace gpu_playground::backend
+{
+
+// Runs the SIMD kernels on a persistent thread pool: element-wise ops and reductions are split
+// in one contiguous range per thread, matrix products in tiles of the output.
+class ThreadedDevice final : public Device
+{
+private:
+  static constexpr DeviceType s_type{DeviceType::THREADED};
+
+  std::unique_ptr<ThreadPool> workers;
+
+public:
+  // Uses one thread per available core when `num_threads` is zero.
+  explicit ThreadedDevice(size_t num_threads);
+
+  ThreadedDevice(ThreadedDevice const &)            = delete;
+  ThreadedDevice(ThreadedDevice &&)                 = delete;
+  ThreadedDevice &operator=(ThreadedDevice const &) = delete;
+  ThreadedDevice &operator=(ThreadedDevice &&)      = delete;
+  ~ThreadedDevice() override                        = default;
+
+  [[nodiscard]] DeviceType type() const override { return ThreadedDevice::s_type; }
+
+  [[nodiscard]] size_t num_threads() const override { return this->workers->size(); }
+
+  void add(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sub(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void mul(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void cmul(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void cdiv(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sadd(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void ssub(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void smul(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sdiv(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void axpy(Buffer const &alpha, Buffer const &x, Buffer &y) const override;
+
+  void axpby(Buffer const &alpha, Buffer const &x, Buffer const &beta, Buffer &y) const override;
+
+  void dot(Buffer const &a, Buffer const &b, Buffer &c) const override;
+
+  void sum(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void max(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void min(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void norm2(Buffer const &a, Buffer &c, Axis axis) const override;
+
+  void eval(ExprProgram const &program, Buffer &out) const override;
+
+  [[nodiscard]] Buffer new_buffer(std::vector<float> data, Shape shape) const override;
+
+  [[nodiscard]] Buffer new_buffer_uninitialized(Shape shape) const override;
+
+  void fill(Buffer &buffer, float value) const override;
+
+  void fill_random(Buffer &buffer, Distribution dist, uint64_t seed) const override;
+
+  void copy_buffer(Buffer const &from, Buffer &to) const override;
+
+  void transpose(Buffer const &from, Buffer &to) const override;
+
+  [[nodiscard]] std::vector<float> cpu(Buffer const &buffer) const override;
+
+  [[nodiscard]] float const *host_data(Buffer const &buffer) const override;
+
+  void sync(Buffer const &buffer) const override;
+};
+
+} // namespace gpu_playground::backend
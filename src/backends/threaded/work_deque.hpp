@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace gpu_playground::backend
+{
+
+// A unit of work forked by one thread and run by whichever thread gets to it first.
+class Job
+{
+private:
+  void (*invoke)(Job &);
+  std::atomic<bool> done{false};
+
+public:
+  explicit Job(void (*invoke)(Job &)) : invoke(invoke) {}
+
+  Job(Job const &)            = delete;
+  Job(Job &&)                 = delete;
+  Job &operator=(Job const &) = delete;
+  Job &operator=(Job &&)      = delete;
+  ~Job()                      = default;
+
+  // Marking the job done is its last access, the thread that forked it may then destroy it.
+  void execute()
+  {
+    this->invoke(*this);
+    this->done.store(true, std::memory_order_release);
+  }
+
+  [[nodiscard]] bool finished() const { return this->done.load(std::memory_order_acquire); }
+};
+
+// Runs a callable as a Job. The callable is borrowed, it must outlive the job.
+template <class F>
+class FnJob final : public Job
+{
+private:
+  F const &fn;
+
+public:
+  explicit FnJob(F const &fn)
+      : Job([](Job &job) -> void { static_cast<FnJob &>(job).fn(); }), fn(fn)
+  {
+  }
+};
+
+// The Chase-Lev work-stealing deque (Chase and Lev, "Dynamic circular work-stealing deque",
+// with the memory orders of Le et al., "Correct and efficient work-stealing for weak memory
+// models"). The owner pushes and pops jobs at the bottom, thieves steal the oldest job at the top.
+// The oldest job is the largest piece of a recursive split, so a steal moves as much work as
+// possible at once.
+//
+// The capacity is fixed: recursive kernels keep one job per level of recursion on the deque, and
+// a push onto a full deque fails so that the caller runs the job itself.
+class WorkDeque
+{
+private:
+  static constexpr int64_t capacity{1024};
+  static constexpr int64_t mask{capacity - 1};
+
+  static_assert((capacity & mask) == 0, "The capacity must be a power of two");
+
+  alignas(64) std::atomic<int64_t> top{0};
+  alignas(64) std::atomic<int64_t> bottom{0};
+  std::array<std::atomic<Job *>, capacity> jobs{};
+
+public:
+  // Owner only.
+  [[nodiscard]] bool push(Job *job)
+  {
+    int64_t const b = this->bottom.load(std::memory_order_relaxed);
+    int64_t const t = this->top.load(std::memory_order_acquire);
+    if (b - t >= capacity)
+    {
+      return false;
+    }
+
+    this->jobs[b & mask].store(job, std::memory_order_relaxed);
+    this->bottom.store(b + 1, std::memory_order_seq_cst);
+    return true;
+  }
+
+  // Owner only, returns null when the deque is empty.
+  [[nodiscard]] Job *pop()
+  {
+    int64_t const b = this->bottom.load(std::memory_order_relaxed) - 1;
+    this->bottom.store(b, std::memory_order_seq_cst);
+    int64_t t = this->top.load(std::memory_order_seq_cst);
+
+    if (t > b)
+    {
+      this->bottom.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    Job *job = this->jobs[b & mask].load(std::memory_order_relaxed);
+    if (t == b)
+    {
+      // The last job, race the thieves for it.
+      if (not this->top.compare_exchange_strong(
+              t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed
+          ))
+      {
+        job = nullptr;
+      }
+      this->bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+  }
+
+  // Any thread, returns null when the deque is empty or another thread won the race.
+  [[nodiscard]] Job *steal()
+  {
+    int64_t t       = this->top.load(std::memory_order_seq_cst);
+    int64_t const b = this->bottom.load(std::memory_order_seq_cst);
+    if (t >= b)
+    {
+      return nullptr;
+    }
+
+    Job *job = this->jobs[t & mask].load(std::memory_order_relaxed);
+    if (not this->top.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed
+        ))
+    {
+      return nullptr;
+    }
+    return job;
+  }
+};
+
+} // namespace gpu_playground::backend
@@ -0,0 +1,105 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "algorithms.hpp"
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+// Independent solves on shared devices, from several threads at once, sharing the matrix, the
+// initial guess and the right-hand sides.
+TEST_CASE("algorithms: concurrent solves", "[algorithms]")
+{
+  auto const all_devices = make_devices();
+  std::vector<DevicePtr> devices(all_devices.cbegin(), all_devices.cend());
+  devices.push_back(make_async_device(all_devices[DeviceIdx::SERIAL]));
+#ifdef GPU_PLAYGROUND_HAS_THREADED
+  devices.push_back(make_threaded_device(4));
+#endif
+
+  constexpr size_t n{64};
+  constexpr size_t n_threads{8};
+  constexpr size_t n_rhs{2};
+
+  std::vector<float> a_data(n * n, 0.0F);
+  for (size_t i{0}; i < n; i++)
+  {
+    a_data[(i * n) + i] = 6.0F;
+    if (i + 1 < n)
+    {
+      a_data[(i * n) + i + 1]   = -1.0F;
+      a_data[((i + 1) * n) + i] = -1.0F;
+    }
+  }
+  auto const make_b = [](size_t const t)
+  {
+    std::vector<float> b(n);
+    for (size_t i{0}; i < n; i++)
+    {
+      b[i] = static_cast<float>((i + t) % 5) + 1.0F;
+    }
+    return b;
+  };
+  Shape const a_shape{n, n};
+  Shape const b_shape{n, 1};
+
+  auto const serial = all_devices[DeviceIdx::SERIAL];
+  std::vector<std::vector<float>> refs;
+  for (size_t r{0}; r < n_rhs; r++)
+  {
+    Tensor const a(a_data, a_shape, serial);
+    Tensor const b(make_b(r), b_shape, serial);
+    refs.push_back(conjuaget_gradient(a, b, Tensor::zeros(b_shape, serial)).cpu());
+  }
+
+  for (size_t d{0}; d < devices.size(); d++)
+  {
+    auto const &device = devices[d];
+    if (device != nullptr)
+    {
+      // Indexed, the list holds several devices of the same type.
+      SECTION(std::to_string(d) + " " + std::string(get_device_name(device->type())))
+      {
+        Tensor const a(a_data, a_shape, device);
+        Tensor const x0 = Tensor::zeros(b_shape, device);
+        std::vector<Tensor> bs;
+        for (size_t r{0}; r < n_rhs; r++)
+        {
+          bs.emplace_back(make_b(r), b_shape, device);
+        }
+
+        std::vector<std::vector<float>> results(n_threads);
+        std::vector<std::thread> threads;
+        for (size_t t{0}; t < n_threads; t++)
+        {
+          threads.emplace_back(
+              [&, t]()
+              {
+                for (size_t solve{0}; solve < 4; solve++)
+                {
+                  results[t] = conjuaget_gradient(a, bs[t % n_rhs], x0).cpu();
+                }
+              }
+          );
+        }
+        for (auto &thread : threads)
+        {
+          thread.join();
+        }
+
+        for (size_t t{0}; t < n_threads; t++)
+        {
+          REQUIRE_THAT(results[t], VectorsWithinAbsRel(refs[t % n_rhs], 1e-5F, 1e-5F));
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,94 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "graph.hpp"
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("algorithms: graph replay", "[algorithms]")
+{
+  auto const devices = make_devices();
+
+  std::vector<float> const s_data{0.5};
+  std::vector<float> const x_data{1.0, 2.0, 3.0, 4.0};
+  std::vector<float> const ref{2.25, 13.5, 42.75, 99.0};
+  Shape const scalar_shape{1, 1};
+  Shape const shape{4, 1};
+  Tensor s(s_data, scalar_shape, devices[DeviceIdx::SERIAL]);
+  Tensor x(x_data, shape, devices[DeviceIdx::SERIAL]);
+  Tensor y = Tensor::zeros(shape, devices[DeviceIdx::SERIAL]);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        s.to(device);
+        x.to(device);
+        y.to(device);
+
+        Graph graph;
+        graph.capture(
+            [&]()
+            {
+              auto const t = x.cmul(x);
+              auto const u = t.sadd(s);
+              auto const v = u.cmul(x);
+              y.axpy(s, v);
+            }
+        );
+        graph.replay();
+        graph.replay();
+
+        REQUIRE(graph.size() == 4);
+        REQUIRE(graph.num_buffers() == 2);
+        REQUIRE_THAT(y.cpu(), VectorsWithinAbsRel(ref));
+      }
+    }
+  }
+}
+
+TEST_CASE("algorithms: graph replay into copies", "[algorithms]")
+{
+  auto const devices = make_devices();
+
+  std::vector<float> const one_data{1.0};
+  std::vector<float> const five_data{5.0};
+  Shape const scalar_shape{1, 1};
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        Tensor const one(one_data, scalar_shape, device);
+        Tensor const keep(five_data, scalar_shape, device);
+        Tensor x = Tensor::zeros(scalar_shape, device);
+
+        Graph graph;
+        graph.capture([&]() { x += one; });
+
+        // Replays write to x alone, whether it was assigned from a tensor or copied to one.
+        x = keep;
+        graph.replay();
+        REQUIRE(x.item() == 6.0);
+        REQUIRE(keep.item() == 5.0);
+
+        Tensor const copy = x;
+        graph.replay();
+        REQUIRE(x.item() == 7.0);
+        REQUIRE(copy.item() == 6.0);
+      }
+    }
+  }
+}
@@ -164,3 +164,21 @@ VectorsWithinAbsRel(std::vector<T> const &expected, T rtol = RTOL<T>, T atol = A
 {
   return WithinAbsRelVectorMatcher<T>(expected, rtol, atol);
 }
+
+// The sizes of a product large enough for the parallel backends to split, none of them a multiple
+// of their blocks or batches.
+constexpr size_t SPLIT_ROWS{517};
+constexpr size_t SPLIT_COLS{263};
+constexpr size_t SPLIT_INNER{129};
+
+// `size` small integers in [-3, 3], starting at a different one for each `offset`. Every product
+// and sum of them is exact, whatever the order a backend accumulates in.
+inline std::vector<float> exact_data(size_t const size, size_t const offset)
+{
+  std::vector<float> data(size);
+  for (size_t i{0}; i < size; i++)
+  {
+    data[i] = static_cast<float>((i + offset) % 7) - 3.0F;
+  }
+  return data;
+}
@@ -0,0 +1,72 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+#ifdef GPU_PLAYGROUND_HAS_EIGEN
+namespace
+{
+
+// Restores the Eigen thread count on exit, as it is shared by every Eigen device.
+struct EigenThreadsScope
+{
+  size_t previous{eigen_threads()};
+
+  EigenThreadsScope() = default;
+
+  EigenThreadsScope(EigenThreadsScope const &)            = delete;
+  EigenThreadsScope(EigenThreadsScope &&)                 = delete;
+  EigenThreadsScope &operator=(EigenThreadsScope const &) = delete;
+  EigenThreadsScope &operator=(EigenThreadsScope &&)      = delete;
+  ~EigenThreadsScope() { set_eigen_threads(this->previous); }
+};
+
+} // namespace
+
+TEST_CASE("matrix: eigen threads", "[matrix]")
+{
+  auto const serial = make_serial_device();
+  auto const eigen  = make_eigen_device();
+
+  constexpr size_t rows{SPLIT_ROWS};
+  constexpr size_t cols{SPLIT_COLS};
+  constexpr size_t inner{SPLIT_INNER};
+
+  auto const a_data = exact_data(rows * inner, 0);
+  auto const b_data = exact_data(inner * cols, 1);
+  Shape const a_shape{rows, inner};
+  Shape const b_shape{inner, cols};
+
+  auto const ref = (Tensor(a_data, a_shape, serial) * Tensor(b_data, b_shape, serial)).cpu();
+
+  Tensor const a(a_data, a_shape, eigen);
+  Tensor const b(b_data, b_shape, eigen);
+
+  for (size_t const num_threads : {1, 3, 0})
+  {
+    SECTION(std::to_string(num_threads) + " threads")
+    {
+      EigenThreadsScope const scope;
+      set_eigen_threads(num_threads);
+      REQUIRE(eigen_threads() >= 1);
+      // Without OpenMP Eigen always runs on one thread.
+#ifdef _OPENMP
+      if (num_threads != 0)
+      {
+        REQUIRE(eigen_threads() == num_threads);
+      }
+#endif
+      REQUIRE_THAT((a * b).cpu(), VectorsWithinAbsRel(ref));
+    }
+  }
+}
+#endif
@@ -0,0 +1,48 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("matrix: min", "[matrix]")
+{
+  auto const devices = make_devices();
+
+  std::vector<float> const data{0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+  std::vector<float> const ref_rows{0.0, 3.0};
+  std::vector<float> const ref_cols{0.0, 1.0, 2.0};
+  std::vector<float> const ref_all{0.0};
+  Shape const shape{2, 3};
+  Tensor a(data, shape, devices[DeviceIdx::SERIAL]);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        a.to(device);
+
+        auto const rows = a.min(Axis::ROWS);
+        auto const cols = a.min(Axis::COLS);
+        auto const all  = a.min();
+
+        REQUIRE(rows.shape().rows == shape.rows);
+        REQUIRE(rows.shape().cols == 1);
+        REQUIRE(cols.shape().rows == 1);
+        REQUIRE(cols.shape().cols == shape.cols);
+        REQUIRE_THAT(rows.cpu(), VectorsWithinAbsRel(ref_rows));
+        REQUIRE_THAT(cols.cpu(), VectorsWithinAbsRel(ref_cols));
+        REQUIRE_THAT(all.cpu(), VectorsWithinAbsRel(ref_all));
+      }
+    }
+  }
+}
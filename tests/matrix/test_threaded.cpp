@@ -0,0 +1,89 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+#ifdef GPU_PLAYGROUND_HAS_THREADED
+TEST_CASE("matrix: threaded", "[matrix]")
+{
+  auto const serial = make_serial_device();
+
+  constexpr size_t rows{SPLIT_ROWS};
+  constexpr size_t cols{SPLIT_COLS};
+  constexpr size_t inner{SPLIT_INNER};
+  constexpr size_t tall_rows{30'011};
+  constexpr size_t tall_cols{9};
+
+  auto const a_data = exact_data(rows * inner, 0);
+  auto const b_data = exact_data(inner * cols, 1);
+  auto const c_data = exact_data(rows * inner, 2);
+  auto const t_data = exact_data(tall_rows * tall_cols, 3);
+  std::vector<float> const s_data{2.0};
+  Shape const a_shape{rows, inner};
+  Shape const b_shape{inner, cols};
+  Shape const t_shape{tall_rows, tall_cols};
+  Shape const scalar_shape{1, 1};
+
+  Tensor const sa(a_data, a_shape, serial);
+  Tensor const sb(b_data, b_shape, serial);
+  Tensor const sc(c_data, a_shape, serial);
+  Tensor const st(t_data, t_shape, serial);
+  Tensor const ss(s_data, scalar_shape, serial);
+
+  for (size_t const num_threads : {1, 3, 8})
+  {
+    SECTION(std::to_string(num_threads) + " threads")
+    {
+      auto const device = make_threaded_device(num_threads);
+
+      Tensor const a(a_data, a_shape, device);
+      Tensor const b(b_data, b_shape, device);
+      Tensor const c(c_data, a_shape, device);
+      Tensor const s(s_data, scalar_shape, device);
+
+      REQUIRE_THAT((a * b).cpu(), VectorsWithinAbsRel((sa * sb).cpu()));
+      REQUIRE_THAT(a.transpose().cpu(), VectorsWithinAbsRel(sa.transpose().cpu()));
+
+      // A tall-skinny product, whose work is all along the inner dimension.
+      Tensor const t(t_data, t_shape, device);
+      REQUIRE_THAT((t.transpose() * t).cpu(), VectorsWithinAbsRel((st.transpose() * st).cpu()));
+
+      REQUIRE_THAT((a + c).cpu(), VectorsWithinAbsRel((sa + sc).cpu()));
+      REQUIRE_THAT(a.cmul(c).cpu(), VectorsWithinAbsRel(sa.cmul(sc).cpu()));
+      REQUIRE_THAT(a.smul(s).cpu(), VectorsWithinAbsRel(sa.smul(ss).cpu()));
+
+      Tensor const e = a.lazy().cmul(c) + a.lazy().smul(s) - c;
+      REQUIRE_THAT(e.cpu(), VectorsWithinAbsRel((sa.cmul(sc) + sa.smul(ss) - sc).cpu()));
+
+      Tensor y = c;
+      y.axpby(s, a, s);
+      REQUIRE_THAT(y.cpu(), VectorsWithinAbsRel((sa.smul(ss) + sc.smul(ss)).cpu()));
+
+      for (auto const axis : {Axis::ALL, Axis::ROWS, Axis::COLS})
+      {
+        REQUIRE_THAT(a.sum(axis).cpu(), VectorsWithinAbsRel(sa.sum(axis).cpu()));
+        REQUIRE_THAT(a.max(axis).cpu(), VectorsWithinAbsRel(sa.max(axis).cpu()));
+        REQUIRE_THAT(a.min(axis).cpu(), VectorsWithinAbsRel(sa.min(axis).cpu()));
+        REQUIRE_THAT(a.norm2(axis).cpu(), VectorsWithinAbsRel(sa.norm2(axis).cpu(), 1e-6F));
+      }
+
+      Shape const flat{rows * inner, 1};
+      Tensor const x(a_data, flat, device);
+      Tensor const z(c_data, flat, device);
+      REQUIRE_THAT(
+          x.dot(z).cpu(),
+          VectorsWithinAbsRel(Tensor(a_data, flat, serial).dot(Tensor(c_data, flat, serial)).cpu())
+      );
+    }
+  }
+}
+#endif
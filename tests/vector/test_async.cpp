@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "basic_tensor.hpp"
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: async", "[vector]")
+{
+  auto const devices = make_devices();
+
+  constexpr size_t len{100'003};
+  std::vector<float> a_data(len);
+  std::vector<float> b_data(len);
+  for (size_t i{0}; i < len; i++)
+  {
+    a_data[i] = static_cast<float>(i % 7) - 3.0F;
+    b_data[i] = static_cast<float>(i % 5) - 2.0F;
+  }
+  Shape const shape{len, 1};
+  Shape const scalar_shape{1, 1};
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr and backend::is_host_device(device->type()))
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        auto const async = make_async_device(device);
+
+        Tensor const a(a_data, shape, device);
+        Tensor const b(b_data, shape, device);
+        Tensor const s(std::vector<float>{2.0F}, scalar_shape, device);
+        Tensor const r = a.lazy().cmul(b) + a.lazy().smul(s) - b;
+        auto const ref = r.cpu();
+
+        Tensor const x(a_data, shape, async);
+        Tensor const y(b_data, shape, async);
+        Tensor const t(std::vector<float>{2.0F}, scalar_shape, async);
+
+        // A chain of ops, read back once at the end.
+        Tensor z = x.cmul(y);
+        z += x.smul(t);
+        z -= y;
+        REQUIRE_THAT(z.cpu(), VectorsWithinAbsRel(ref));
+
+        Tensor const e = x.lazy().cmul(y) + x.lazy().smul(t) - y;
+        REQUIRE_THAT(e.cpu(), VectorsWithinAbsRel(ref));
+
+        REQUIRE(x.dot(y).item() == a.dot(b).item());
+        REQUIRE(x.sum().item() == a.sum().item());
+
+        // The inputs go away while the op using them may still be queued.
+        Tensor w = Tensor::zeros(shape, async);
+        {
+          Tensor const u(a_data, shape, async);
+          Tensor const v = u + u;
+          w              = v.cmul(u);
+        }
+        REQUIRE_THAT(w.cpu(), VectorsWithinAbsRel(a.cmul(a).smul(s).cpu()));
+
+        // Moving between the synchronous and asynchronous device keeps the queued work.
+        Tensor m(a_data, shape, device);
+        m.to(async);
+        m += m;
+        m.to(device);
+        m += a;
+        REQUIRE_THAT(m.cpu(), VectorsWithinAbsRel((a.smul(s) + a).cpu()));
+
+        // A product queued ahead keeps the stream busy, so the ops below are still in flight
+        // when the memory they use changes hands.
+        Shape const busy_shape{200, 200};
+        Tensor const busy_in(std::vector<float>(200 * 200, 0.5F), busy_shape, async);
+
+        // External memory is poisoned then freed by its deleter, which must wait for the sum.
+        {
+          auto *external = static_cast<float *>(
+              ::operator new(len * sizeof(float), std::align_val_t{backend::host_alignment})
+          );
+          std::copy(a_data.cbegin(), a_data.cend(), external);
+          auto const release = [](float *ptr)
+          {
+            std::fill_n(ptr, len, std::numeric_limits<float>::quiet_NaN());
+            ::operator delete(ptr, std::align_val_t{backend::host_alignment});
+          };
+
+          Tensor const busy = busy_in * busy_in;
+          Tensor total      = Tensor::zeros(scalar_shape, async);
+          {
+            auto const e = Tensor::from_external(external, shape, async, release);
+            Tensor::sum_into(e, total);
+          }
+          REQUIRE(total.item() == a.sum().item());
+        }
+
+        // A tensor taken over by a HostTensor has its queued writes landed first.
+        {
+          Tensor const busy = busy_in * busy_in;
+          Tensor doubled    = x + x;
+          HostTensor const host(std::move(doubled));
+          REQUIRE(host.cpu() == (a + a).cpu());
+        }
+
+        // A HostTensor handed to the asynchronous device is freed after the ops queued on it.
+        {
+          Tensor const busy = busy_in * busy_in;
+          Tensor product    = Tensor::zeros(shape, async);
+          {
+            auto const from_host = HostTensor(a_data, shape).to_tensor(async);
+            Tensor::cmul_into(from_host, x, product);
+          }
+          REQUIRE(product.cpu() == a.cmul(a).cpu());
+        }
+
+        async->trim_pool();
+      }
+    }
+  }
+}
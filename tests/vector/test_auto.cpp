@@ -0,0 +1,126 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: auto", "[vector]")
+{
+  auto const devices = make_devices();
+  auto const serial  = devices[DeviceIdx::SERIAL];
+  auto const device  = devices[DeviceIdx::AUTO];
+
+  REQUIRE(device != nullptr);
+  REQUIRE(device->type() == DeviceType::AUTO);
+
+  // Sizes on both sides of the calibrated ones, so that several backends may run the ops.
+  for (size_t const len : {7, 1'000, 100'003, 3'000'001})
+  {
+    SECTION("vector " + std::to_string(len))
+    {
+      auto const a_data = exact_data(len, 0);
+      auto const b_data = exact_data(len, 1);
+      Shape const shape{len, 1};
+
+      Tensor const sa(a_data, shape, serial);
+      Tensor const sb(b_data, shape, serial);
+      Tensor const a(a_data, shape, device);
+      Tensor const b(b_data, shape, device);
+
+      REQUIRE_THAT((a + b).cpu(), VectorsWithinAbsRel((sa + sb).cpu()));
+      REQUIRE_THAT(a.cmul(b).cpu(), VectorsWithinAbsRel(sa.cmul(sb).cpu()));
+      REQUIRE_THAT(a.dot(b).cpu(), VectorsWithinAbsRel(sa.dot(sb).cpu()));
+      REQUIRE_THAT(a.sum().cpu(), VectorsWithinAbsRel(sa.sum().cpu()));
+      REQUIRE_THAT(a.max().cpu(), VectorsWithinAbsRel(sa.max().cpu()));
+    }
+  }
+
+  for (size_t const side : {3, 40, 300})
+  {
+    SECTION("matrix " + std::to_string(side))
+    {
+      auto const a_data = exact_data(side * side, 0);
+      auto const x_data = exact_data(side, 1);
+      Shape const shape{side, side};
+      Shape const x_shape{side, 1};
+
+      Tensor const sa(a_data, shape, serial);
+      Tensor const sx(x_data, x_shape, serial);
+      Tensor const a(a_data, shape, device);
+      Tensor const x(x_data, x_shape, device);
+
+      REQUIRE_THAT((a * a).cpu(), VectorsWithinAbsRel((sa * sa).cpu()));
+      REQUIRE_THAT((a * x).cpu(), VectorsWithinAbsRel((sa * sx).cpu()));
+      REQUIRE_THAT(a.transpose().cpu(), VectorsWithinAbsRel(sa.transpose().cpu()));
+      REQUIRE_THAT(a.sum(Axis::COLS).cpu(), VectorsWithinAbsRel(sa.sum(Axis::COLS).cpu()));
+    }
+  }
+
+  SECTION("zero copy")
+  {
+    auto const a_data = exact_data(100'003, 0);
+    Shape const shape{100'003, 1};
+
+    // The output of the auto device is used in place by every other CPU device, and back.
+    Tensor const a(a_data, shape, device);
+    Tensor b           = a + a;
+    auto const *before = b.host_view().data();
+    for (auto const &other : devices)
+    {
+      if (other != nullptr and backend::is_host_device(other->type()))
+      {
+        b.to(other);
+        REQUIRE(b.host_view().data() == before);
+        b.to(device);
+        REQUIRE(b.host_view().data() == before);
+      }
+    }
+    REQUIRE_THAT(b.cpu(), VectorsWithinAbsRel((a + a).cpu()));
+  }
+
+#ifdef GPU_PLAYGROUND_HAS_THREADED
+  SECTION("calibration")
+  {
+    // Making devices times nothing. The first op does, once for every set of thread counts.
+    auto const calibrations = auto_device_calibrations();
+    auto const fresh        = make_devices();
+    auto const two          = make_auto_device({serial, make_threaded_device(2)});
+    auto const two_again    = make_auto_device({serial, make_threaded_device(2)});
+    auto const five         = make_auto_device({serial, make_threaded_device(5)});
+    REQUIRE(auto_device_calibrations() == calibrations);
+
+    auto const data = exact_data(1'003, 0);
+    Shape const shape{1'003, 1};
+    Tensor const a(data, shape, two);
+    REQUIRE(auto_device_calibrations() == calibrations + 1);
+    Tensor const b(data, shape, two_again);
+    REQUIRE(auto_device_calibrations() == calibrations + 1);
+    Tensor const c(data, shape, five);
+    REQUIRE(auto_device_calibrations() == calibrations + 2);
+    REQUIRE_THAT(c.dot(c).cpu(), VectorsWithinAbsRel(a.dot(b).cpu()));
+  }
+#endif
+
+  SECTION("single device")
+  {
+    // Over a single device, every op runs on it.
+    auto const only = make_auto_device({serial});
+
+    auto const a_data = exact_data(1'003, 0);
+    Shape const shape{1'003, 1};
+    Tensor const sa(a_data, shape, serial);
+    Tensor const a(a_data, shape, only);
+
+    REQUIRE((a + a).cpu() == (sa + sa).cpu());
+    REQUIRE(a.dot(a).cpu() == sa.dot(sa).cpu());
+    REQUIRE(a.norm2().cpu() == sa.norm2().cpu());
+  }
+}
@@ -0,0 +1,45 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: axpy", "[vector]")
+{
+  auto const devices = make_devices();
+
+  std::vector<float> const alpha_data{2.0};
+  std::vector<float> const x_data{0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+  std::vector<float> const y_data{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  std::vector<float> const ref{1.0, 4.0, 7.0, 10.0, 13.0, 16.0};
+  Shape const scalar_shape{1, 1};
+  Shape const shape{6, 1};
+  Tensor alpha(alpha_data, scalar_shape, devices[DeviceIdx::SERIAL]);
+  Tensor x(x_data, shape, devices[DeviceIdx::SERIAL]);
+  Tensor y(y_data, shape, devices[DeviceIdx::SERIAL]);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        alpha.to(device);
+        x.to(device);
+        y.to(device);
+
+        y.axpy(alpha, x);
+
+        REQUIRE_THAT(y.cpu(), VectorsWithinAbsRel(ref));
+      }
+    }
+  }
+}
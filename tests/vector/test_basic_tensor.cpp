@@ -0,0 +1,83 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "basic_tensor.hpp"
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: basic tensor", "[vector]")
+{
+  std::vector<float> const a_data{0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+  std::vector<float> const b_data{5.0, 4.0, 3.0, 2.0, 1.0, 0.0};
+  Shape const shape{6, 1};
+
+  HostTensor const a(a_data, shape);
+  HostTensor const b(b_data, shape);
+  HostTensor const two({2.0}, {1, 1});
+
+  REQUIRE_THAT((a + b).cpu(), VectorsWithinAbsRel(std::vector<float>(6, 5.0)));
+  REQUIRE_THAT(
+      (a - b).cpu(), VectorsWithinAbsRel(std::vector<float>{-5.0, -3.0, -1.0, 1.0, 3.0, 5.0})
+  );
+  REQUIRE_THAT(
+      a.cmul(b).cpu(), VectorsWithinAbsRel(std::vector<float>{0.0, 4.0, 6.0, 6.0, 4.0, 0.0})
+  );
+  REQUIRE_THAT(
+      a.smul(two).cpu(), VectorsWithinAbsRel(std::vector<float>{0.0, 2.0, 4.0, 6.0, 8.0, 10.0})
+  );
+  REQUIRE(a.dot(b).item() == 20.0);
+  REQUIRE(a.sum().item() == 15.0);
+  REQUIRE(a.max().item() == 5.0);
+  REQUIRE(a.min().item() == 0.0);
+
+  auto c = b;
+  c.axpby(two, a, two);
+  REQUIRE_THAT(c.cpu(), VectorsWithinAbsRel(std::vector<float>(6, 10.0)));
+
+  HostTensor const m({1.0, 2.0, 3.0, 4.0, 5.0, 6.0}, {2, 3});
+  REQUIRE_THAT(
+      m.transpose().cpu(), VectorsWithinAbsRel(std::vector<float>{1.0, 4.0, 2.0, 5.0, 3.0, 6.0})
+  );
+  REQUIRE_THAT(
+      (m * m.transpose()).cpu(), VectorsWithinAbsRel(std::vector<float>{14.0, 32.0, 32.0, 77.0})
+  );
+  REQUIRE_THAT(m.sum(Axis::ROWS).cpu(), VectorsWithinAbsRel(std::vector<float>{6.0, 15.0}));
+  REQUIRE_THAT(m.sum(Axis::COLS).cpu(), VectorsWithinAbsRel(std::vector<float>{5.0, 7.0, 9.0}));
+}
+
+TEST_CASE("vector: basic tensor conversion", "[vector]")
+{
+  auto const devices = make_devices();
+
+  std::vector<float> const a_data{0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+  Shape const shape{6, 1};
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr and backend::is_host_device(device->type()))
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        HostTensor a(a_data, shape);
+        auto const *data = a.host_view().data();
+
+        // Host devices share the storage, the buffer moves across without a copy.
+        auto b = std::move(a).to_tensor(device);
+        REQUIRE(b.host_view().data() == data);
+        REQUIRE(b.dot(b).item() == 55.0);
+
+        HostTensor const c(std::move(b));
+        REQUIRE(c.host_view().data() == data);
+        REQUIRE_THAT(c.cpu(), VectorsWithinAbsRel(a_data));
+      }
+    }
+  }
+}
@@ -0,0 +1,68 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: copy on write", "[vector]")
+{
+  auto const devices = make_devices();
+
+  std::vector<float> const a_data{0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+  std::vector<float> const ref{0.0, 2.0, 4.0, 6.0, 8.0, 10.0};
+  Shape const shape{6, 1};
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        Tensor const two({2.0}, {1, 1}, device);
+        Tensor a(a_data, shape, device);
+
+        auto const misses = device->pool_stats().misses;
+        auto b            = a;
+        auto c            = a;
+        REQUIRE(device->pool_stats().misses == misses);
+        REQUIRE(b.host_view().data() == a.host_view().data());
+
+        // Writing to a copy leaves the others untouched.
+        b.smul_(two);
+        REQUIRE(b.host_view().data() != a.host_view().data());
+        REQUIRE_THAT(b.cpu(), VectorsWithinAbsRel(ref));
+        REQUIRE_THAT(a.cpu(), VectorsWithinAbsRel(a_data));
+
+        // Writing to the original leaves its copies untouched.
+        a += a;
+        REQUIRE_THAT(a.cpu(), VectorsWithinAbsRel(ref));
+        REQUIRE_THAT(c.cpu(), VectorsWithinAbsRel(a_data));
+
+        // The last tensor sharing a buffer writes to it in place.
+        auto const *c_data = c.host_view().data();
+        c.smul_(two);
+        REQUIRE(c.host_view().data() == c_data);
+        REQUIRE_THAT(c.cpu(), VectorsWithinAbsRel(ref));
+
+        // A deep copy has a buffer of its own from the start.
+        auto const d = Tensor::deep_copy(a);
+        REQUIRE(d.host_view().data() != a.host_view().data());
+        REQUIRE_THAT(d.cpu(), VectorsWithinAbsRel(a.cpu()));
+
+        // Assigning copies into the existing buffer.
+        auto const *b_data = b.host_view().data();
+        b                  = c;
+        REQUIRE(b.host_view().data() == b_data);
+        REQUIRE_THAT((a - b).cpu(), VectorsWithinAbsRel(std::vector<float>(6, 0.0)));
+      }
+    }
+  }
+}
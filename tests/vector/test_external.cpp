@@ -0,0 +1,64 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: from external", "[vector]")
+{
+  auto const devices = make_devices();
+
+  std::vector<float> const ref{0.0, 2.0, 4.0, 6.0, 8.0, 10.0};
+  Shape const shape{6, 1};
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr and backend::is_host_device(device->type()))
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        alignas(backend::host_alignment) float borrowed[6]{0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+        float const *released{nullptr};
+
+        {
+          auto a = Tensor::from_external(borrowed, shape, device);
+          REQUIRE(a.host_view().data() == borrowed);
+          REQUIRE_THAT((a + a).cpu(), VectorsWithinAbsRel(ref));
+
+          // Writes go straight to the external memory.
+          a.smul_(Tensor({2.0}, {1, 1}, device));
+          REQUIRE_THAT(std::vector<float>(borrowed, borrowed + 6), VectorsWithinAbsRel(ref));
+
+          auto b = Tensor::from_external(
+              borrowed, shape, device, [&released](float *ptr) { released = ptr; }
+          );
+          REQUIRE(b.dot(b).item() == 220.0);
+        }
+
+        REQUIRE(released == borrowed);
+
+        // Memory the kernels cannot load in aligned batches is rejected, and left to the caller.
+        bool misaligned_released{false};
+        REQUIRE_THROWS_AS(
+            Tensor::from_external(
+                borrowed + 1,
+                Shape{4, 1},
+                device,
+                [&misaligned_released](float *) { misaligned_released = true; }
+            ),
+            std::invalid_argument
+        );
+        REQUIRE(not misaligned_released);
+      }
+    }
+  }
+}
@@ -0,0 +1,41 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: fill", "[vector]")
+{
+  auto const devices = make_devices();
+
+  constexpr size_t len{37};
+  std::vector<float> const ref_zeros(len, 0.0);
+  std::vector<float> const ref_ones(len, 1.0);
+  std::vector<float> const ref_full(len, 2.5);
+  Shape const shape{len, 1};
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        REQUIRE_THAT(Tensor::zeros(shape, device).cpu(), VectorsWithinAbsRel(ref_zeros));
+        REQUIRE_THAT(Tensor::ones(shape, device).cpu(), VectorsWithinAbsRel(ref_ones));
+        REQUIRE_THAT(Tensor::full(shape, 2.5, device).cpu(), VectorsWithinAbsRel(ref_full));
+
+        auto buffer = device->new_buffer_uninitialized(shape);
+        device->fill(buffer, 2.5);
+        REQUIRE_THAT(device->cpu(buffer), VectorsWithinAbsRel(ref_full));
+      }
+    }
+  }
+}
@@ -0,0 +1,147 @@
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+namespace
+{
+
+// Restores the host storage config at the end of a test, whatever way the test leaves it.
+struct HostStorageScope
+{
+  backend::HostStorageConfig previous{backend::host_storage_config()};
+
+  HostStorageScope() = default;
+
+  HostStorageScope(HostStorageScope const &)            = delete;
+  HostStorageScope(HostStorageScope &&)                 = delete;
+  HostStorageScope &operator=(HostStorageScope const &) = delete;
+  HostStorageScope &operator=(HostStorageScope &&)      = delete;
+  ~HostStorageScope() { backend::host_storage_config() = this->previous; }
+};
+
+[[nodiscard]] bool huge_page_aligned(float const *data)
+{
+  return reinterpret_cast<std::uintptr_t>(data) % backend::huge_page_size == 0;
+}
+
+} // namespace
+
+TEST_CASE("vector: large host storage", "[vector]")
+{
+  auto const devices = make_devices();
+
+  HostStorageScope const scope;
+  auto &config    = backend::host_storage_config();
+  config.prefault = true;
+
+  // Exactly at the threshold, the smallest size that takes the large allocation path.
+  constexpr size_t len{(size_t{4} << 20) / sizeof(float)};
+  config.huge_page_threshold = len * sizeof(float);
+  Shape const shape{len, 1};
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr and backend::is_host_device(device->type()))
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        auto const before = backend::host_storage_stats();
+
+        auto const a = Tensor::ones(shape, device);
+        auto const b = a + a;
+        REQUIRE(b.sum().item() == 2.0F * len);
+
+        auto const after = backend::host_storage_stats();
+        auto const large = after.prefaulted_buffers - before.prefaulted_buffers;
+        REQUIRE(after.buffers > before.buffers);
+        REQUIRE(large > 0);
+
+#if defined(__linux__)
+        // Large buffers are mapped on huge page boundaries, and the kernel takes the request for
+        // transparent huge pages wherever it supports them.
+        REQUIRE(huge_page_aligned(a.host_view().data()));
+        REQUIRE(huge_page_aligned(b.host_view().data()));
+        if (std::filesystem::exists("/sys/kernel/mm/transparent_hugepage/enabled"))
+        {
+          REQUIRE(after.huge_page_buffers - before.huge_page_buffers == large);
+        }
+#endif
+      }
+    }
+  }
+}
+
+TEST_CASE("vector: numa policy", "[vector]")
+{
+  auto const host_devices = make_devices();
+  std::vector<DevicePtr> devices(host_devices.cbegin(), host_devices.cend());
+#ifdef GPU_PLAYGROUND_HAS_THREADED
+  // The default threaded device may have a single thread, which touches everything itself.
+  devices.push_back(make_threaded_device(4));
+#endif
+
+  HostStorageScope const scope;
+  auto &config    = backend::host_storage_config();
+  config.prefault = true;
+
+  constexpr size_t len{(size_t{4} << 20) / sizeof(float)};
+  config.huge_page_threshold = len * sizeof(float);
+  Shape const shape{len, 1};
+
+  std::vector<float> data(len);
+  std::vector<float> twice(len);
+  for (size_t i{0}; i < len; i++)
+  {
+    data[i]  = static_cast<float>(i % 5);
+    twice[i] = 2.0F * data[i];
+  }
+
+  for (auto const policy : {backend::NumaPolicy::FIRST_TOUCH, backend::NumaPolicy::INTERLEAVE})
+  {
+    config.numa = policy;
+
+    for (auto const &device : devices)
+    {
+      if (device != nullptr and backend::is_host_device(device->type()))
+      {
+        auto const before = backend::host_storage_stats();
+
+        Tensor const a(data, shape, device);
+        auto const b = a + a;
+        REQUIRE(b.cpu() == twice);
+
+        auto const after = backend::host_storage_stats();
+        auto const large = after.buffers - before.buffers;
+        if (policy == backend::NumaPolicy::FIRST_TOUCH)
+        {
+          // Pages are left to the device, never prefaulted by the allocating thread.
+          REQUIRE(after.prefaulted_buffers == before.prefaulted_buffers);
+          REQUIRE(after.first_touch_buffers - before.first_touch_buffers <= large);
+          if (device->type() == DeviceType::THREADED)
+          {
+            REQUIRE(after.first_touch_buffers - before.first_touch_buffers == large);
+          }
+        }
+        else
+        {
+          // The kernel may refuse the policy, for instance in a container, but never for more
+          // buffers than were allocated.
+          REQUIRE(after.interleaved_buffers - before.interleaved_buffers <= large);
+          REQUIRE(after.prefaulted_buffers > before.prefaulted_buffers);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,42 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: host view", "[vector]")
+{
+  auto const devices = make_devices();
+
+  std::vector<float> const a_data{0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+  std::vector<float> const ref{0.0, 2.0, 4.0, 6.0, 8.0, 10.0};
+  Shape const shape{6, 1};
+  Tensor a(a_data, shape, devices[DeviceIdx::SERIAL]);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        a.to(device);
+
+        auto const b    = a + a;
+        auto const view = b.host_view();
+        REQUIRE(view.size() == ref.size());
+        REQUIRE_THAT(std::vector<float>(view.begin(), view.end()), VectorsWithinAbsRel(ref));
+        REQUIRE(view(3, 0) == 6.0);
+
+        REQUIRE(a.dot(a).item() == 55.0);
+      }
+    }
+  }
+}
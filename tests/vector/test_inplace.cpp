@@ -0,0 +1,46 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: inplace", "[vector]")
+{
+  auto const devices = make_devices();
+
+  std::vector<float> const s_data{2.0};
+  std::vector<float> const a_data{0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+  std::vector<float> const b_data{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  std::vector<float> const ref{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  Shape const scalar_shape{1, 1};
+  Shape const shape{6, 1};
+  Tensor s(s_data, scalar_shape, devices[DeviceIdx::SERIAL]);
+  Tensor a(a_data, shape, devices[DeviceIdx::SERIAL]);
+  Tensor b(b_data, shape, devices[DeviceIdx::SERIAL]);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        s.to(device);
+        a.to(device);
+        b.to(device);
+
+        // ((((a * b) / b + 2) * 2) - 2) / 2 = a + 1
+        a.cmul_(b).cdiv_(b).sadd_(s).smul_(s).ssub_(s).sdiv_(s);
+
+        REQUIRE_THAT(a.cpu(), VectorsWithinAbsRel(ref));
+      }
+    }
+  }
+}
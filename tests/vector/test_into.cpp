@@ -0,0 +1,64 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: into", "[vector]")
+{
+  auto const devices = make_devices();
+
+  std::vector<float> const s_data{2.0};
+  std::vector<float> const a_data{0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+  std::vector<float> const b_data{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  std::vector<float> const ref_cmul{0.0, 2.0, 6.0, 12.0, 20.0, 30.0};
+  std::vector<float> const ref_sadd{2.0, 3.0, 4.0, 5.0, 6.0, 7.0};
+  std::vector<float> const ref_dot{70.0};
+  std::vector<float> const ref_sum{15.0};
+  std::vector<float> const ref_mean{2.5};
+  Shape const scalar_shape{1, 1};
+  Shape const shape{6, 1};
+  Tensor s(s_data, scalar_shape, devices[DeviceIdx::SERIAL]);
+  Tensor a(a_data, shape, devices[DeviceIdx::SERIAL]);
+  Tensor b(b_data, shape, devices[DeviceIdx::SERIAL]);
+  Tensor out        = Tensor::zeros(shape, devices[DeviceIdx::SERIAL]);
+  Tensor scalar_out = Tensor::zeros(scalar_shape, devices[DeviceIdx::SERIAL]);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        s.to(device);
+        a.to(device);
+        b.to(device);
+        out.to(device);
+        scalar_out.to(device);
+
+        Tensor::cmul_into(a, b, out);
+        REQUIRE_THAT(out.cpu(), VectorsWithinAbsRel(ref_cmul));
+
+        Tensor::sadd_into(a, s, out);
+        REQUIRE_THAT(out.cpu(), VectorsWithinAbsRel(ref_sadd));
+
+        Tensor::dot_into(a, b, scalar_out);
+        REQUIRE_THAT(scalar_out.cpu(), VectorsWithinAbsRel(ref_dot));
+
+        Tensor::sum_into(a, scalar_out);
+        REQUIRE_THAT(scalar_out.cpu(), VectorsWithinAbsRel(ref_sum));
+
+        Tensor::mean_into(a, scalar_out);
+        REQUIRE_THAT(scalar_out.cpu(), VectorsWithinAbsRel(ref_mean));
+      }
+    }
+  }
+}
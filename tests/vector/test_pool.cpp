@@ -0,0 +1,58 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: pool", "[vector]")
+{
+  auto const devices = make_devices();
+
+  std::vector<float> const a_data{0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+  std::vector<float> const b_data{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  std::vector<float> const ref{0.0, 2.0, 6.0, 12.0, 20.0, 30.0};
+  Shape const shape{6, 1};
+  size_t const bytes{6 * sizeof(float)};
+  Tensor a(a_data, shape, devices[DeviceIdx::SERIAL]);
+  Tensor b(b_data, shape, devices[DeviceIdx::SERIAL]);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        a.to(device);
+        b.to(device);
+
+        {
+          auto const c = a.cmul(b);
+          REQUIRE_THAT(c.cpu(), VectorsWithinAbsRel(ref));
+        }
+        REQUIRE(device->pool_stats().misses == 1);
+        REQUIRE(device->pool_stats().bytes_cached == bytes);
+
+        {
+          auto const c = a.cmul(b);
+          REQUIRE_THAT(c.cpu(), VectorsWithinAbsRel(ref));
+        }
+        REQUIRE(device->pool_stats().hits == 1);
+        REQUIRE(device->pool_stats().misses == 1);
+
+        device->trim_pool();
+        REQUIRE(device->pool_stats().bytes_cached == 0);
+
+        auto const c = a.cmul(b);
+        REQUIRE(device->pool_stats().misses == 2);
+      }
+    }
+  }
+}
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: random", "[vector]")
+{
+  auto const devices = make_devices();
+
+  // Large enough to be filled by several threads.
+  constexpr size_t len{1 << 18};
+  Shape const shape{len, 1};
+  auto const ref = Tensor::rand(shape, devices[DeviceIdx::SERIAL], 42).cpu();
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        // The values only depend on the seed, whatever the device or the size.
+        REQUIRE_THAT(Tensor::rand(shape, device, 42).cpu(), VectorsWithinAbsRel(ref));
+        auto const head = Tensor::rand({7, 1}, device, 42).cpu();
+        REQUIRE(std::equal(head.cbegin(), head.cend(), ref.cbegin()));
+        REQUIRE(Tensor::rand({7, 1}, device, 43).cpu() != head);
+
+        auto const uniform = Tensor::random(shape, Distribution::uniform(-2.0, 3.0), device, 1);
+        REQUIRE(uniform.min().item() >= -2.0);
+        REQUIRE(uniform.max().item() < 3.0);
+        REQUIRE(std::abs(uniform.mean().item() - 0.5) < 0.05);
+
+        auto const normal = Tensor::random(shape, Distribution::normal(1.0, 2.0), device, 2).cpu();
+        auto const mean   = std::accumulate(normal.cbegin(), normal.cend(), 0.0) / len;
+        double var{0.0};
+        for (auto const x : normal)
+        {
+          var += (x - mean) * (x - mean);
+        }
+        var /= len;
+        REQUIRE(std::abs(mean - 1.0) < 0.05);
+        REQUIRE(std::abs(std::sqrt(var) - 2.0) < 0.05);
+      }
+    }
+  }
+}
+
+TEST_CASE("vector: random philox", "[vector]")
+{
+  // The known answer of Philox4x32-10 for a zero counter and key, from the Random123 test vectors.
+  backend::Philox const philox{0};
+  REQUIRE(philox(0) == std::array<uint32_t, 4>{0x6627E8D5, 0xE169C58D, 0xBC57AC4C, 0x9B00DBD8});
+
+  // Batches give the same blocks as one at a time.
+  constexpr size_t lanes{backend::random_lanes};
+  backend::Philox const seeded{42};
+  auto const bits = seeded.batch<lanes>(uint64_t{1} << 32);
+  for (size_t l{0}; l < lanes; l++)
+  {
+    auto const block = seeded((uint64_t{1} << 32) + l);
+    for (size_t w{0}; w < 4; w++)
+    {
+      REQUIRE(bits[w][l] == block[w]);
+    }
+  }
+}
@@ -0,0 +1,119 @@
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "reproducible.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+namespace
+{
+
+// Turns the reproducible mode on for the scope of a test, whatever way the test leaves it.
+struct ReproducibleScope
+{
+  bool previous{backend::reduction_config().reproducible};
+
+  ReproducibleScope() { backend::reduction_config().reproducible = true; }
+
+  ReproducibleScope(ReproducibleScope const &)            = delete;
+  ReproducibleScope(ReproducibleScope &&)                 = delete;
+  ReproducibleScope &operator=(ReproducibleScope const &) = delete;
+  ReproducibleScope &operator=(ReproducibleScope &&)      = delete;
+  ~ReproducibleScope() { backend::reduction_config().reproducible = this->previous; }
+};
+
+} // namespace
+
+TEST_CASE("vector: reproducible reductions", "[vector]")
+{
+  auto const devices = make_devices();
+  auto const serial  = devices[DeviceIdx::SERIAL];
+
+  // Values whose sums round differently in every order, over several leaves and a partial one,
+  // and a matrix whose rows and columns do not fill the blocks.
+  constexpr size_t len{100'003};
+  constexpr size_t rows{1'037};
+  constexpr size_t cols{263};
+
+  auto const make_data = [](size_t const size, float const phase)
+  {
+    std::vector<float> data(size);
+    for (size_t i{0}; i < size; i++)
+    {
+      data[i] = std::sin((static_cast<float>(i) * 0.618F) + phase) + 1.5F;
+    }
+    return data;
+  };
+
+  auto const x_data = make_data(len, 0.0F);
+  auto const y_data = make_data(len, 1.0F);
+  auto const m_data = make_data(rows * cols, 2.0F);
+  Shape const x_shape{len, 1};
+  Shape const m_shape{rows, cols};
+
+  // The default kernels, which the reproducible mode must agree with up to rounding.
+  Tensor const fast_x(x_data, x_shape, serial);
+  Tensor const fast_y(y_data, x_shape, serial);
+  Tensor const fast_m(m_data, m_shape, serial);
+  auto const fast_dot = fast_x.dot(fast_y).cpu();
+
+  ReproducibleScope const scope;
+
+  Tensor const ref_x(x_data, x_shape, serial);
+  Tensor const ref_y(y_data, x_shape, serial);
+  Tensor const ref_m(m_data, m_shape, serial);
+  auto const ref_dot = ref_x.dot(ref_y).cpu();
+  REQUIRE_THAT(ref_dot, VectorsWithinAbsRel(fast_dot, 1e-5F));
+
+  std::vector<DevicePtr> targets;
+  for (auto const &device : devices)
+  {
+    if (device != nullptr and backend::is_host_device(device->type()))
+    {
+      targets.push_back(device);
+    }
+  }
+  targets.push_back(make_async_device(make_serial_device()));
+#ifdef GPU_PLAYGROUND_HAS_THREADED
+  for (size_t const num_threads : {1, 3, 8})
+  {
+    targets.push_back(make_threaded_device(num_threads));
+  }
+#endif
+
+  for (size_t d{0}; d < targets.size(); d++)
+  {
+    auto const &device = targets[d];
+    SECTION(std::to_string(d) + ": " + std::string(get_device_name(device->type())))
+    {
+      Tensor const x(x_data, x_shape, device);
+      Tensor const y(y_data, x_shape, device);
+      Tensor const m(m_data, m_shape, device);
+
+      // Bitwise equal, not just close.
+      REQUIRE(x.dot(y).cpu() == ref_dot);
+      REQUIRE(x.sum().cpu() == ref_x.sum().cpu());
+      REQUIRE(x.norm2().cpu() == ref_x.norm2().cpu());
+
+      for (auto const axis : {Axis::ALL, Axis::ROWS, Axis::COLS})
+      {
+        REQUIRE(m.sum(axis).cpu() == ref_m.sum(axis).cpu());
+        REQUIRE(m.max(axis).cpu() == ref_m.max(axis).cpu());
+        REQUIRE(m.min(axis).cpu() == ref_m.min(axis).cpu());
+        REQUIRE(m.norm2(axis).cpu() == ref_m.norm2(axis).cpu());
+
+        REQUIRE_THAT(m.sum(axis).cpu(), VectorsWithinAbsRel(fast_m.sum(axis).cpu(), 1e-5F));
+        REQUIRE_THAT(m.norm2(axis).cpu(), VectorsWithinAbsRel(fast_m.norm2(axis).cpu(), 1e-5F));
+      }
+    }
+  }
+}
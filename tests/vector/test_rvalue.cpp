@@ -0,0 +1,51 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: rvalue", "[vector]")
+{
+  auto const devices = make_devices();
+
+  std::vector<float> const s_data{2.0};
+  std::vector<float> const a_data{0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+  std::vector<float> const b_data{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  std::vector<float> const ref_add{3.0, 6.0, 9.0, 12.0, 15.0, 18.0};
+  std::vector<float> const ref_sub{-1.0, 0.0, 3.0, 8.0, 15.0, 24.0};
+  Shape const scalar_shape{1, 1};
+  Shape const shape{6, 1};
+  Tensor s(s_data, scalar_shape, devices[DeviceIdx::SERIAL]);
+  Tensor a(a_data, shape, devices[DeviceIdx::SERIAL]);
+  Tensor b(b_data, shape, devices[DeviceIdx::SERIAL]);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        s.to(device);
+        a.to(device);
+        b.to(device);
+
+        // Only the first temporary allocates, the others reuse its buffer.
+        auto const c = b + a.smul(s).sadd(s);
+        REQUIRE_THAT(c.cpu(), VectorsWithinAbsRel(ref_add));
+        REQUIRE(device->pool_stats().misses == 1);
+
+        auto const d = a.cmul(b) - b;
+        REQUIRE_THAT(d.cpu(), VectorsWithinAbsRel(ref_sub));
+        REQUIRE(device->pool_stats().misses == 2);
+      }
+    }
+  }
+}
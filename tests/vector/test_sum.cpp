@@ -0,0 +1,42 @@
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: sum", "[vector]")
+{
+  auto const devices = make_devices();
+
+  // Long enough to go through the unrolled accumulators and the remainder loop.
+  constexpr size_t len{37};
+  std::vector<float> data(len);
+  std::iota(data.begin(), data.end(), 1.0);
+  std::vector<float> const ref{703.0};
+  Shape const shape{len, 1};
+  Tensor a(data, shape, devices[DeviceIdx::SERIAL]);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        a.to(device);
+
+        auto const c = a.sum();
+
+        REQUIRE_THAT(c.cpu(), VectorsWithinAbsRel(ref));
+      }
+    }
+  }
+}
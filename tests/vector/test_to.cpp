@@ -0,0 +1,48 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers.hpp"
+
+#include "device.hpp"
+
+#include "matchers.hpp"
+#include "tensor.hpp"
+
+using namespace Catch::Matchers;
+using namespace gpu_playground;
+
+TEST_CASE("vector: to", "[vector]")
+{
+  auto const devices = make_devices();
+
+  std::vector<float> const a_data{0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+  std::vector<float> const ref{0.0, 2.0, 4.0, 6.0, 8.0, 10.0};
+  Shape const shape{6, 1};
+  Tensor a(a_data, shape, devices[DeviceIdx::SERIAL]);
+
+  for (auto const &device : devices)
+  {
+    if (device != nullptr)
+    {
+      SECTION(std::string(get_device_name(device->type())))
+      {
+        auto const *before = a.host_view().data();
+        a.to(device);
+
+        REQUIRE(a.get_device() == device);
+        REQUIRE_THAT(a.cpu(), VectorsWithinAbsRel(a_data));
+        REQUIRE_THAT((a + a).cpu(), VectorsWithinAbsRel(ref));
+
+        // Moving between CPU backends keeps the same memory.
+        if (backend::is_host_device(device->type()))
+        {
+          REQUIRE(a.host_view().data() == before);
+        }
+
+        a.to(devices[DeviceIdx::SERIAL]);
+        REQUIRE_THAT(a.cpu(), VectorsWithinAbsRel(a_data));
+      }
+    }
+  }
+}